@@ -0,0 +1,257 @@
+#include "BenchCommon.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSet>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+// 基线中必须有、且参与延迟比较的各项
+const char* const kLatencyKeys[] = { "gate", "preprocess", "forward", "decode", "nms", "total", "p95Total" };
+}
+
+double percentile(std::vector<double> v, double p)
+{
+    if (v.empty())
+        return 0;
+    std::sort(v.begin(), v.end());
+    size_t idx = std::min(v.size() - 1, size_t(p * (v.size() - 1) + 0.5));
+    return v[idx];
+}
+
+double iou(const cv::Rect& a, const cv::Rect& b)
+{
+    double inter = (a & b).area();
+    double uni = a.area() + b.area() - inter;
+    return uni > 0 ? inter / uni : 0;
+}
+
+double frameAgreement(const QJsonArray& base, const std::vector<Detection>& cur)
+{
+    if (base.isEmpty() && cur.empty())
+        return 1.0;
+    std::vector<bool> used(cur.size(), false);
+    int matched = 0;
+    for (const QJsonValue& v : base) {
+        QJsonObject o = v.toObject();
+        QJsonArray b = o["box"].toArray();
+        cv::Rect box(b[0].toInt(), b[1].toInt(), b[2].toInt(), b[3].toInt());
+        std::string label = o["label"].toString().toStdString();
+        for (size_t i = 0; i < cur.size(); ++i) {
+            if (!used[i] && cur[i].label == label && iou(cur[i].box, box) >= 0.5) {
+                used[i] = true;
+                ++matched;
+                break;
+            }
+        }
+    }
+    return double(matched) / std::max<size_t>(size_t(base.size()), cur.size());
+}
+
+std::vector<BenchFrame> loadFrames(const QString& dataDir, std::vector<std::unique_ptr<FrameReplay>>& clips)
+{
+    std::vector<BenchFrame> frames;
+    QDir dir(dataDir);
+    QStringList files = dir.entryList({ "*.jpg", "*.jpeg", "*.png", "*.bmp", "*.gcap" },
+        QDir::Files, QDir::Name);
+    for (const QString& f : files) {
+        std::string path = dir.absoluteFilePath(f).toStdString();
+        if (f.endsWith(".gcap")) {
+            clips.emplace_back(new FrameReplay);
+            FrameReplay& clip = *clips.back();
+            if (!clip.open(path))
+                continue;
+            for (size_t i = 0; i < clip.frameCount(); ++i) {
+                BenchFrame bf;
+                bf.key = QString("%1#%2").arg(f).arg(i);
+                if (clip.frame(i, bf.image))
+                    frames.push_back(bf);
+            }
+        } else {
+            BenchFrame bf;
+            bf.key = f + "#0";
+            bf.image = cv::imread(path, cv::IMREAD_COLOR);
+            if (!bf.image.empty())
+                frames.push_back(bf);
+        }
+    }
+    return frames;
+}
+
+QJsonObject modelInfo(const QString& path)
+{
+    QFile f(path);
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    if (!f.open(QIODevice::ReadOnly) || !hash.addData(&f))
+        return QJsonObject();
+    QJsonObject o;
+    o["file"] = QFileInfo(path).fileName();
+    o["bytes"] = double(f.size());
+    o["sha256"] = QString::fromLatin1(hash.result().toHex());
+    return o;
+}
+
+QJsonObject latencyToJson(const LatencySummary& s)
+{
+    QJsonObject o;
+    o["gate"] = s.gate;
+    o["preprocess"] = s.preprocess;
+    o["forward"] = s.forward;
+    o["decode"] = s.decode;
+    o["nms"] = s.nms;
+    o["total"] = s.total;
+    o["p50Total"] = s.p50Total;
+    o["p95Total"] = s.p95Total;
+    return o;
+}
+
+QJsonArray detectionsToJson(const std::vector<Detection>& dets)
+{
+    QJsonArray arr;
+    for (const Detection& d : dets) {
+        QJsonObject o;
+        o["label"] = QString::fromStdString(d.label);
+        o["conf"] = d.conf;
+        o["box"] = QJsonArray { d.box.x, d.box.y, d.box.width, d.box.height };
+        arr.append(o);
+    }
+    return arr;
+}
+
+QJsonObject makeBaseline(float threshold, const QJsonObject& models, const LatencySummary& sum, long peakRssKb,
+    const std::vector<BenchFrame>& frames, const std::vector<std::vector<Detection>>& results)
+{
+    QJsonObject root;
+    root["threshold"] = threshold;
+    root["models"] = models;
+    root["latencyMs"] = latencyToJson(sum);
+    root["fps"] = sum.fps;
+    root["peakRssKb"] = double(peakRssKb);
+    QJsonObject detsObj;
+    for (size_t i = 0; i < frames.size(); ++i)
+        detsObj[frames[i].key] = detectionsToJson(results[i]);
+    root["detections"] = detsObj;
+    return root;
+}
+
+bool parseBaseline(const QByteArray& json, QJsonObject& base, QString& error)
+{
+    QJsonParseError pe;
+    QJsonDocument doc = QJsonDocument::fromJson(json, &pe);
+    if (pe.error != QJsonParseError::NoError || !doc.isObject()) {
+        error = "invalid JSON: " + pe.errorString();
+        return false;
+    }
+    base = doc.object();
+    if (!base.value("threshold").isDouble()) {
+        error = "missing \"threshold\"";
+        return false;
+    }
+    if (!base.value("detections").isObject()) {
+        error = "missing \"detections\"";
+        return false;
+    }
+    if (!base.value("models").toObject().value("model").isObject()) {
+        error = "missing \"models\" (regenerate the baseline with bench-baseline)";
+        return false;
+    }
+    // 延迟与机器相关，但每个基线都必须含延迟，否则延迟回归永远不会被检出
+    const QJsonObject lat = base.value("latencyMs").toObject();
+    for (const char* key : kLatencyKeys) {
+        if (!lat.value(key).isDouble()) {
+            error = QString("missing \"latencyMs.%1\" (run bench-baseline on this machine)").arg(QLatin1String(key));
+            return false;
+        }
+    }
+    const QJsonObject dets = base.value("detections").toObject();
+    bool positive = false;
+    for (auto it = dets.begin(); it != dets.end() && !positive; ++it)
+        positive = !it.value().toArray().isEmpty();
+    if (!positive) {
+        error = "no frame in \"detections\" has a detection; add frames with garbage objects to the data set";
+        return false;
+    }
+    return true;
+}
+
+CompareResult compareBaseline(const QJsonObject& base, const LatencySummary& sum,
+    const std::vector<BenchFrame>& frames, const std::vector<std::vector<Detection>>& results,
+    const CompareOptions& opts)
+{
+    CompareResult r;
+
+    // 检测结果只有在相同阈值下才可比
+    const double baseThreshold = base["threshold"].toDouble();
+    if (std::fabs(baseThreshold - double(opts.threshold)) > 1e-4) {
+        r.thresholdMismatch = true;
+        std::printf("[bench] threshold %.4g differs from baseline threshold %.4g: "
+                    "rerun with --threshold %.4g or regenerate the baseline\n",
+            double(opts.threshold), baseThreshold, baseThreshold);
+        return r;
+    }
+
+    // 检测结果只有在相同模型下才可比
+    const QJsonObject baseModels = base["models"].toObject();
+    for (const char* key : { "model", "gate" }) {
+        const QJsonObject b = baseModels.value(key).toObject();
+        const QJsonObject c = opts.models.value(key).toObject();
+        if (b != c) {
+            r.modelMismatch = true;
+            std::printf("[bench] %s differs from baseline: %s (%s) vs baseline %s (%s)\n", key,
+                qPrintable(c["file"].toString()), qPrintable(c["sha256"].toString().left(12)),
+                qPrintable(b["file"].toString()), qPrintable(b["sha256"].toString().left(12)));
+        }
+    }
+    if (r.modelMismatch)
+        return r;
+
+    // 延迟回归：各阶段平均值及总耗时 p95 不得超过 基线*(1+tolerance)+slack
+    QJsonObject baseLat = base["latencyMs"].toObject();
+    QJsonObject curLat = latencyToJson(sum);
+    for (const char* stage : kLatencyKeys) {
+        double b = baseLat[stage].toDouble();
+        double c = curLat[stage].toDouble();
+        double limit = b * (1.0 + opts.tolerance) + opts.slackMs;
+        bool pass = c <= limit;
+        std::printf("[bench] %-10s %8.3f ms  baseline %8.3f  limit %8.3f  %s\n",
+            stage, c, b, limit, pass ? "ok" : "REGRESSED");
+        r.latencyPass = r.latencyPass && pass;
+    }
+
+    // 检测一致性：数据集与基线帧不对应说明数据集已变化，需要重新生成基线
+    QJsonObject baseDets = base["detections"].toObject();
+    QSet<QString> seen;
+    int positives = 0;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        seen.insert(frames[i].key);
+        if (!baseDets.contains(frames[i].key)) {
+            std::printf("[bench] frame %s not in baseline (regenerate the baseline)\n", qPrintable(frames[i].key));
+            ++r.missingFrames;
+            continue;
+        }
+        const QJsonArray expected = baseDets[frames[i].key].toArray();
+        const double a = frameAgreement(expected, results[i]);
+        r.agreement += a;
+        if (!expected.isEmpty()) {
+            r.positiveAgreement += a;
+            ++positives;
+        }
+    }
+    for (auto it = baseDets.begin(); it != baseDets.end(); ++it) {
+        if (!seen.contains(it.key())) {
+            std::printf("[bench] baseline frame %s not in data set\n", qPrintable(it.key()));
+            ++r.staleFrames;
+        }
+    }
+    r.agreement = frames.empty() ? 0 : r.agreement / double(frames.size());
+    r.positiveAgreement = positives ? r.positiveAgreement / positives : 0;
+    // 两项都须达标：空载帧多时，只看总体一致性会让漏检全部目标的检测器通过
+    r.agreementPass = positives > 0 && r.agreement >= opts.minAgreement && r.positiveAgreement >= opts.minAgreement;
+    std::printf("[bench] detection agreement: %.4f, on %d frames with objects %.4f (min %.4f)  %s\n",
+        r.agreement, positives, r.positiveAgreement, opts.minAgreement, r.agreementPass ? "ok" : "REGRESSED");
+    return r;
+}
@@ -0,0 +1,78 @@
+#ifndef BENCHCOMMON_H
+#define BENCHCOMMON_H
+
+#include "FrameReplay.h"
+#include "YoloEngine.h"
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <memory>
+#include <vector>
+
+// 基准测试公共部分：数据加载、一致性评分、基线读写与比较（不依赖模型，可单独测试）
+
+// 一帧基准输入
+struct BenchFrame {
+    QString key; // 来源标识：文件名#帧号
+    cv::Mat image;
+};
+
+// 各阶段耗时汇总
+struct LatencySummary {
+    double gate = 0, preprocess = 0, forward = 0, decode = 0, nms = 0, total = 0; // 平均值（每帧）
+    double p50Total = 0, p95Total = 0; // 总耗时分位数
+    double fps = 0;
+};
+
+// 基线比较参数
+struct CompareOptions {
+    float threshold = 0.5f; // 本次运行的置信度阈值，须与基线一致
+    QJsonObject models; // 本次运行的模型标识（见 modelInfo），须与基线一致
+    double tolerance = 0.25; // 允许的相对延迟回归
+    double slackMs = 0.5; // 每阶段允许的绝对延迟余量
+    double minAgreement = 0.95; // 最低检测一致性
+};
+
+// 基线比较结果
+struct CompareResult {
+    bool thresholdMismatch = false; // 阈值与基线不同，检测结果不可比
+    bool modelMismatch = false; // 模型文件与生成基线时不同
+    bool latencyPass = true;
+    double agreement = 0; // 全部帧的平均一致性
+    double positiveAgreement = 0; // 基线有检测结果的帧的平均一致性（空结果无法在这些帧上得分）
+    bool agreementPass = false;
+    int missingFrames = 0; // 当前数据中基线没有的帧
+    int staleFrames = 0; // 基线中当前数据没有的帧
+    bool ok() const
+    {
+        return !thresholdMismatch && !modelMismatch && latencyPass && agreementPass
+            && missingFrames == 0 && staleFrames == 0;
+    }
+};
+
+// 排序后取分位数
+double percentile(std::vector<double> v, double p);
+double iou(const cv::Rect& a, const cv::Rect& b);
+// 单帧一致性：同类别且 IoU>=0.5 视为匹配，返回 matched / max(基线数, 当前数)
+double frameAgreement(const QJsonArray& base, const std::vector<Detection>& cur);
+
+// 加载数据目录：图片逐张读取，.gcap 录制片段逐帧读取（按文件名排序保证顺序确定）；
+// 片段保持映射直到 clips 释放，Raw 帧零拷贝引用映射内存
+std::vector<BenchFrame> loadFrames(const QString& dataDir, std::vector<std::unique_ptr<FrameReplay>>& clips);
+
+// 模型文件标识：文件名、字节数和 SHA-256，文件不可读时返回空对象
+QJsonObject modelInfo(const QString& path);
+QJsonObject latencyToJson(const LatencySummary& s);
+QJsonArray detectionsToJson(const std::vector<Detection>& dets);
+// 生成基线 JSON，models 为生成时使用的模型标识
+QJsonObject makeBaseline(float threshold, const QJsonObject& models, const LatencySummary& sum, long peakRssKb,
+    const std::vector<BenchFrame>& frames, const std::vector<std::vector<Detection>>& results);
+// 解析基线文件内容，必须含 threshold、models.model、完整的 latencyMs，且至少一帧有检测结果
+// （全空的基线无法区分正常检测器与什么都不输出的检测器）；失败返回 false 并填写 error
+bool parseBaseline(const QByteArray& json, QJsonObject& base, QString& error);
+// 与基线比较并逐项打印结果
+CompareResult compareBaseline(const QJsonObject& base, const LatencySummary& sum,
+    const std::vector<BenchFrame>& frames, const std::vector<std::vector<Detection>>& results,
+    const CompareOptions& opts);
+
+#endif // BENCHCOMMON_H
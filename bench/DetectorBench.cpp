@@ -0,0 +1,207 @@
+#include "BenchCommon.h"
+#include "CascadeGate.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <sys/resource.h>
+
+// 检测基准测试：在本地图片/录制片段上运行检测流程，统计各阶段耗时、FPS、峰值内存，
+// 并与基线 JSON 比较延迟和检测一致性。退出码：0 通过，1 回归或无法比较（缺少模型/数据/基线）
+
+namespace {
+const int EXIT_REGRESSION = 1;
+
+// 当前进程峰值常驻内存（KB）
+long peakRssKb()
+{
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless detection benchmark.");
+    parser.addHelpOption();
+    QCommandLineOption modelOpt("model", "ONNX model path.", "file", "resources/yolov5s.onnx");
+    QCommandLineOption dataOpt("data", "Directory of images and .gcap clips.", "dir", "bench/data");
+    QCommandLineOption baselineOpt("baseline", "Baseline JSON path.", "file", "bench/baseline.json");
+    QCommandLineOption updateOpt("update-baseline", "Write results as the new baseline.");
+    QCommandLineOption threshOpt("threshold", "Confidence threshold.", "value", "0.5");
+    QCommandLineOption tolOpt("tolerance", "Allowed relative latency regression.", "ratio", "0.25");
+    QCommandLineOption slackOpt("slack-ms", "Absolute latency slack per stage (ms).", "ms", "0.5");
+    QCommandLineOption agreeOpt("min-agreement", "Minimum detection agreement with baseline.", "ratio", "0.95");
+    QCommandLineOption warmupOpt("warmup", "Warm-up iterations before timing.", "n", "3");
+    QCommandLineOption repeatOpt("repeat", "Timed passes over the data set.", "n", "3");
+    QCommandLineOption gateOpt("gate-model", "Benchmark the two-stage cascade with this first-stage model.", "file");
+    QCommandLineOption gateSizeOpt("gate-size", "First-stage input size.", "pixels", "192");
+    QCommandLineOption gateThreshOpt("gate-threshold", "First-stage score needed to run the full detector.", "value", "0.25");
+    QCommandLineOption gateHoldOpt("gate-hold", "Frames to keep running the full detector after the gate fires.", "n", "5");
+    parser.addOptions({ modelOpt, dataOpt, baselineOpt, updateOpt, threshOpt, tolOpt,
+        slackOpt, agreeOpt, warmupOpt, repeatOpt, gateOpt, gateSizeOpt, gateThreshOpt, gateHoldOpt });
+    parser.process(app);
+
+    const float threshold = parser.value(threshOpt).toFloat();
+    const double tolerance = parser.value(tolOpt).toDouble();
+    const double slackMs = parser.value(slackOpt).toDouble();
+    const double minAgreement = parser.value(agreeOpt).toDouble();
+    const int warmup = parser.value(warmupOpt).toInt();
+    const int repeat = std::max(1, parser.value(repeatOpt).toInt());
+
+    // 缺少模型或数据时判失败而不是跳过，否则回归门禁在没有模型的机器上永远不生效
+    QJsonObject models;
+    models["model"] = modelInfo(parser.value(modelOpt));
+    if (models["model"].toObject().isEmpty()) {
+        std::printf("[bench] FAIL: model not found: %s (set -DBENCH_MODEL=...)\n", qPrintable(parser.value(modelOpt)));
+        return EXIT_REGRESSION;
+    }
+    std::vector<std::unique_ptr<FrameReplay>> clips;
+    std::vector<BenchFrame> frames = loadFrames(parser.value(dataOpt), clips);
+    if (frames.empty()) {
+        std::printf("[bench] FAIL: no images or clips in %s\n", qPrintable(parser.value(dataOpt)));
+        return EXIT_REGRESSION;
+    }
+
+    // 基准固定使用 CPU 推理，保证在无 GPU 的机器上可复现
+    YoloEngine engine(parser.value(modelOpt).toStdString(), false);
+    if (!engine.isLoaded()) {
+        std::printf("[bench] FAIL: model load failed\n");
+        return EXIT_REGRESSION;
+    }
+
+    // 可选：两级级联（第一阶段同样使用 CPU）
+    std::unique_ptr<CascadeGate> gate;
+    if (parser.isSet(gateOpt)) {
+        CascadeOptions co;
+        co.gateModelPath = parser.value(gateOpt).toStdString();
+        co.inputSize = parser.value(gateSizeOpt).toInt();
+        co.gateThreshold = parser.value(gateThreshOpt).toFloat();
+        co.holdFrames = parser.value(gateHoldOpt).toInt();
+        gate.reset(new CascadeGate(co, engine.classNames(), false));
+        if (!gate->isLoaded()) {
+            std::printf("[bench] FAIL: gate model load failed\n");
+            return EXIT_REGRESSION;
+        }
+        // 级联参数影响检测结果，与第一阶段模型一起记入基线
+        QJsonObject gateInfo = modelInfo(parser.value(gateOpt));
+        gateInfo["inputSize"] = co.inputSize;
+        gateInfo["threshold"] = co.gateThreshold;
+        gateInfo["hold"] = co.holdFrames;
+        models["gate"] = gateInfo;
+    }
+
+    std::vector<Detection> dets;
+    StageTimes t;
+    for (int i = 0; i < warmup; ++i) {
+        engine.detect(frames[0].image, threshold, dets, &t);
+        if (gate)
+            gate->pass(frames[0].image);
+    }
+    if (gate)
+        gate->reset();
+
+    // 计时：repeat 轮遍历全部帧，检测结果取最后一轮
+    std::vector<double> totals;
+    std::vector<std::vector<Detection>> results(frames.size());
+    LatencySummary sum;
+    auto wallStart = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeat; ++r) {
+        for (size_t i = 0; i < frames.size(); ++i) {
+            // 级联：第一阶段未通过时跳过完整检测，该帧只计门控耗时
+            double gateBefore = gate ? gate->stats().gateMs : 0;
+            bool full = !gate || gate->pass(frames[i].image);
+            double gateMs = gate ? gate->stats().gateMs - gateBefore : 0;
+            sum.gate += gateMs;
+            if (!full) {
+                results[i].clear();
+                totals.push_back(gateMs);
+                continue;
+            }
+            if (!engine.detect(frames[i].image, threshold, results[i], &t)) {
+                std::printf("[bench] FAIL: detect failed on %s\n", qPrintable(frames[i].key));
+                return EXIT_REGRESSION;
+            }
+            if (gate)
+                gate->recordFullRun(t.totalMs());
+            sum.preprocess += t.preprocessMs;
+            sum.forward += t.forwardMs;
+            sum.decode += t.decodeMs;
+            sum.nms += t.nmsMs;
+            totals.push_back(gateMs + t.totalMs());
+        }
+    }
+    double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    const double n = double(totals.size());
+    sum.gate /= n;
+    sum.preprocess /= n;
+    sum.forward /= n;
+    sum.decode /= n;
+    sum.nms /= n;
+    sum.total = sum.gate + sum.preprocess + sum.forward + sum.decode + sum.nms;
+    sum.p50Total = percentile(totals, 0.50);
+    sum.p95Total = percentile(totals, 0.95);
+    sum.fps = wallSec > 0 ? n / wallSec : 0;
+    const long rssKb = peakRssKb();
+
+    std::printf("[bench] frames: %zu x %d passes\n", frames.size(), repeat);
+    std::printf("[bench] latency ms (mean): gate %.3f  preprocess %.3f  forward %.3f  decode %.3f  nms %.3f  total %.3f\n",
+        sum.gate, sum.preprocess, sum.forward, sum.decode, sum.nms, sum.total);
+    std::printf("[bench] latency ms total: p50 %.3f  p95 %.3f\n", sum.p50Total, sum.p95Total);
+    std::printf("[bench] fps: %.2f  peak rss: %ld KB\n", sum.fps, rssKb);
+    if (gate) {
+        const CascadeStats& cs = gate->stats();
+        std::printf("[bench] cascade: gate passed %llu/%llu frames (%.1f%%), full runs %llu, est. saved %.1f ms\n",
+            (unsigned long long)cs.passed, (unsigned long long)cs.frames, cs.runRatio() * 100,
+            (unsigned long long)cs.fullRuns, cs.savedMs());
+    }
+
+    // 写入新基线；不合格的基线（如数据集中没有任何检测结果）不写入
+    if (parser.isSet(updateOpt)) {
+        const QByteArray json = QJsonDocument(makeBaseline(threshold, models, sum, rssKb, frames, results)).toJson();
+        QJsonObject check;
+        QString error;
+        if (!parseBaseline(json, check, error)) {
+            std::printf("[bench] FAIL: baseline not written: %s\n", qPrintable(error));
+            return EXIT_REGRESSION;
+        }
+        QFile f(parser.value(baselineOpt));
+        if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::printf("[bench] FAIL: cannot write baseline %s\n", qPrintable(f.fileName()));
+            return EXIT_REGRESSION;
+        }
+        f.write(json);
+        std::printf("[bench] baseline written: %s\n", qPrintable(f.fileName()));
+        return 0;
+    }
+
+    // 与基线比较
+    QFile f(parser.value(baselineOpt));
+    if (!f.open(QIODevice::ReadOnly)) {
+        std::printf("[bench] FAIL: no baseline %s (run bench-baseline on this machine)\n", qPrintable(f.fileName()));
+        return EXIT_REGRESSION;
+    }
+    QJsonObject base;
+    QString error;
+    if (!parseBaseline(f.readAll(), base, error)) {
+        std::printf("[bench] FAIL: bad baseline %s: %s\n", qPrintable(f.fileName()), qPrintable(error));
+        return EXIT_REGRESSION;
+    }
+    CompareOptions cmp;
+    cmp.threshold = threshold;
+    cmp.models = models;
+    cmp.tolerance = tolerance;
+    cmp.slackMs = slackMs;
+    cmp.minAgreement = minAgreement;
+    CompareResult result = compareBaseline(base, sum, frames, results, cmp);
+    std::printf("[bench] %s\n", result.ok() ? "PASS" : "FAIL");
+    return result.ok() ? 0 : EXIT_REGRESSION;
+}
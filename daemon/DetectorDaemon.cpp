@@ -0,0 +1,60 @@
+#include "AppOptions.h"
+#include "Detector.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QTimer>
+#include <atomic>
+#include <csignal>
+
+// 检测守护进程：独立于界面运行 Detector，将每帧图像和检测结果发布到共享内存帧总线，
+// 界面（--attach）、日志、分拣控制器等本地客户端可同时只读映射；界面崩溃或重启不影响模型和摄像头
+
+namespace {
+std::atomic<bool> g_quit(false);
+
+void onSignal(int)
+{
+    g_quit = true;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless detector daemon publishing to a shared-memory frame bus.");
+    parser.addHelpOption();
+    addAppOptions(parser);
+    parser.process(app);
+    AppOptions opts = readAppOptions(parser);
+    if (!opts.bus.enabled())
+        opts.bus.name = "/gc_frames"; // 守护进程默认启用帧总线
+
+    Detector detector(opts.modelPath, opts.threshold);
+    detector.setCaptureOptions(opts.capture);
+    detector.setEventOptions(opts.events);
+    detector.setFrameBusOptions(opts.bus);
+    detector.setCascadeOptions(opts.cascade);
+    // 检测线程退出（摄像头打开失败、回放结束）时守护进程随之退出
+    QObject::connect(&detector, &QThread::finished, &app, &QCoreApplication::quit);
+
+    // 信号处理函数只置标志，由定时器在事件循环中退出
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    QTimer quitTimer;
+    QObject::connect(&quitTimer, &QTimer::timeout, [&app] {
+        if (g_quit)
+            app.quit();
+    });
+    quitTimer.start(100);
+
+    qDebug() << "[DetectorDaemon] Frame bus:" << QString::fromStdString(opts.bus.name);
+    detector.start();
+    int rc = app.exec();
+
+    detector.stop();
+    detector.wait();
+    qDebug() << "[DetectorDaemon] Exit.";
+    return rc;
+}
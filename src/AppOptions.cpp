@@ -0,0 +1,57 @@
+#include "AppOptions.h"
+#include <algorithm>
+
+// 注册命令行参数
+void addAppOptions(QCommandLineParser& parser)
+{
+    // 模型
+    parser.addOption({ "model", "ONNX model path.", "file", "../resources/yolov5s.onnx" });
+    parser.addOption({ "threshold", "Detection confidence threshold.", "value", "0.5" });
+    // 两级级联
+    parser.addOption({ "gate-model", "Tiny first-stage ONNX model; run the full detector only when it fires.", "file" });
+    parser.addOption({ "gate-size", "First-stage input size.", "pixels", "192" });
+    parser.addOption({ "gate-threshold", "First-stage score needed to run the full detector.", "value", "0.25" });
+    parser.addOption({ "gate-hold", "Frames to keep running the full detector after the gate fires.", "n", "5" });
+    // 录制/回放
+    parser.addOption({ "record", "Record camera frames to <file>.", "file" });
+    parser.addOption({ "mjpeg", "Record frames as MJPEG instead of raw pixels." });
+    parser.addOption({ "replay", "Replay frames from <file> instead of the camera.", "file" });
+    parser.addOption({ "replay-fast", "Replay as fast as possible instead of original timing." });
+    // 检测事件发布
+    parser.addOption({ "event-socket", "Publish detection events on Unix socket <path>.", "path" });
+    parser.addOption({ "event-shm", "Publish detection events to shared-memory ring <name>.", "name" });
+    parser.addOption({ "event-format", "Socket event format: json or binary.", "format", "json" });
+    parser.addOption({ "event-drop", "Drop policy when the queue is full: oldest or newest.", "policy", "oldest" });
+    // 帧总线
+    parser.addOption({ "bus", "Publish frames and results to shared-memory frame bus <name>.", "name" });
+    parser.addOption({ "bus-slots", "Frame bus ring size.", "n", "4" });
+    parser.addOption({ "attach", "GUI only: show results from the detector daemon's frame bus <name>.", "name" });
+}
+
+// 读取命令行参数
+AppOptions readAppOptions(const QCommandLineParser& parser)
+{
+    AppOptions opts;
+    opts.modelPath = parser.value("model").toStdString();
+    opts.threshold = parser.value("threshold").toFloat();
+
+    opts.cascade.gateModelPath = parser.value("gate-model").toStdString();
+    opts.cascade.inputSize = parser.value("gate-size").toInt();
+    opts.cascade.gateThreshold = parser.value("gate-threshold").toFloat();
+    opts.cascade.holdFrames = parser.value("gate-hold").toInt();
+
+    opts.capture.recordPath = parser.value("record").toStdString();
+    opts.capture.recordMjpeg = parser.isSet("mjpeg");
+    opts.capture.replayPath = parser.value("replay").toStdString();
+    opts.capture.replayRealtime = !parser.isSet("replay-fast");
+
+    opts.events.socketPath = parser.value("event-socket").toStdString();
+    opts.events.shmName = parser.value("event-shm").toStdString();
+    opts.events.format = parser.value("event-format") == "binary" ? EventStreamFormat::Binary : EventStreamFormat::JsonLines;
+    opts.events.dropPolicy = parser.value("event-drop") == "newest" ? EventDropPolicy::DropNewest : EventDropPolicy::DropOldest;
+
+    opts.bus.name = parser.value("bus").toStdString();
+    opts.bus.slots = std::max(2u, parser.value("bus-slots").toUInt());
+    opts.attach = parser.value("attach").toStdString();
+    return opts;
+}
@@ -0,0 +1,24 @@
+#ifndef APPOPTIONS_H
+#define APPOPTIONS_H
+
+#include "Detector.h"
+#include <QCommandLineParser>
+#include <string>
+
+// 程序配置：界面程序和检测守护进程共用的命令行参数
+struct AppOptions {
+    std::string modelPath = "../resources/yolov5s.onnx"; // 模型路径
+    float threshold = 0.5f; // 检测置信度阈值
+    CaptureOptions capture; // 录制/回放
+    EventOptions events; // 检测事件发布
+    FrameBusOptions bus; // 帧总线（本进程作为写端）
+    CascadeOptions cascade; // 两级级联
+    std::string attach; // 非空时界面连接该帧总线，不在本进程加载模型和打开摄像头
+};
+
+// 向 parser 注册全部参数
+void addAppOptions(QCommandLineParser& parser);
+// 从已解析的 parser 读取配置
+AppOptions readAppOptions(const QCommandLineParser& parser);
+
+#endif // APPOPTIONS_H
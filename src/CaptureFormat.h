@@ -0,0 +1,85 @@
+#ifndef CAPTUREFORMAT_H
+#define CAPTUREFORMAT_H
+
+#include <cstdint>
+
+// 录制文件（.gcap）格式定义
+//
+// 文件布局（全部小端）：
+//   FileHeader
+//   RecordHeader + payload（逐帧追加写入，每条记录按 kAlign 对齐）
+//   ...
+//   IndexHeader + IndexEntry[count]（关闭时写入）
+//   Trailer（文件末尾，指向索引）
+//
+// 若录制进程异常退出导致没有索引/尾部，回放端会按 RecordHeader 顺序扫描重建索引。
+namespace CaptureFormat {
+
+const uint32_t kFileMagic = 0x50414347; // "GCAP"
+const uint32_t kRecordMagic = 0x4D415246; // "FRAM"
+const uint32_t kIndexMagic = 0x58444E49; // "INDX"
+const uint32_t kTrailerMagic = 0x444E4547; // "GEND"
+const uint32_t kVersion = 1;
+const uint64_t kAlign = 64; // 记录对齐字节数，保证 Raw 帧映射后数据按缓存行对齐
+
+// 帧编码方式
+enum Codec : uint32_t {
+    Raw = 0, // 原始像素（cv::Mat 紧凑行存储）
+    Mjpeg = 1 // 逐帧 JPEG 编码
+};
+
+// 文件头
+struct FileHeader {
+    uint32_t magic; // kFileMagic
+    uint32_t version; // kVersion
+    uint64_t reserved;
+};
+
+// 每帧记录头，大小为 kAlign，payload 紧随其后
+struct RecordHeader {
+    uint32_t magic; // kRecordMagic
+    uint32_t codec; // Codec
+    int32_t width; // 图像宽
+    int32_t height; // 图像高
+    int32_t type; // cv::Mat 类型（如 CV_8UC3）
+    uint32_t step; // Raw 帧每行字节数
+    int64_t timestampUs; // 采集时间戳（微秒，系统时钟）
+    uint64_t payloadSize; // payload 实际字节数（不含对齐填充）
+    uint8_t reserved[24];
+};
+
+// 索引头
+struct IndexHeader {
+    uint32_t magic; // kIndexMagic
+    uint32_t reserved;
+    uint64_t count; // 索引条目数
+};
+
+// 索引条目
+struct IndexEntry {
+    uint64_t offset; // RecordHeader 在文件中的偏移
+    int64_t timestampUs; // 采集时间戳（微秒）
+};
+
+// 文件尾
+struct Trailer {
+    uint64_t indexOffset; // IndexHeader 在文件中的偏移
+    uint32_t magic; // kTrailerMagic
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 16, "FileHeader layout");
+static_assert(sizeof(RecordHeader) == kAlign, "RecordHeader layout");
+static_assert(sizeof(IndexHeader) == 16, "IndexHeader layout");
+static_assert(sizeof(IndexEntry) == 16, "IndexEntry layout");
+static_assert(sizeof(Trailer) == 16, "Trailer layout");
+
+// 向上对齐到 kAlign
+inline uint64_t alignUp(uint64_t n)
+{
+    return (n + kAlign - 1) / kAlign * kAlign;
+}
+
+} // namespace CaptureFormat
+
+#endif // CAPTUREFORMAT_H
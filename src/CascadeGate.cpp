@@ -0,0 +1,150 @@
+#include "CascadeGate.h"
+#include "CocoMap.h"
+#include <QDebug>
+#include <QString>
+#include <algorithm>
+#include <chrono>
+
+CascadeGate::CascadeGate(const CascadeOptions& opts, const std::vector<std::string>& classNames, bool useCuda)
+    : opts_(opts)
+    , loaded_(false)
+    , holdLeft_(0)
+{
+    qDebug() << "[CascadeGate] Loading gate model:" << QString::fromStdString(opts_.gateModelPath)
+             << "input:" << opts_.inputSize << "threshold:" << opts_.gateThreshold;
+    // 输入尺寸须为 32 的倍数（YOLOv5 最大下采样步长），且在小模型的合理范围内
+    if (opts_.inputSize < 160 || opts_.inputSize > 256 || opts_.inputSize % 32 != 0) {
+        qDebug() << "[CascadeGate] Invalid gate input size (160~256, multiple of 32):" << opts_.inputSize;
+        return;
+    }
+    // 类别名缺失时无法判断检测器输出的类别是否相关，门控将永远不通过，完整检测永远不运行
+    if (classNames.empty()) {
+        qDebug() << "[CascadeGate] No class names (coco.names not loaded), cascade disabled.";
+        return;
+    }
+    try {
+        net_ = cv::dnn::readNet(opts_.gateModelPath);
+        if (useCuda) {
+            net_.setPreferableBackend(cv::dnn::DNN_BACKEND_CUDA);
+            net_.setPreferableTarget(cv::dnn::DNN_TARGET_CUDA_FP16);
+        } else {
+            net_.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+            net_.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+        }
+        outNames_ = net_.getUnconnectedOutLayersNames();
+        if (net_.empty())
+            return;
+        // 用空白图运行一次，确认输出形状（同时完成预热）
+        cv::Mat probe(opts_.inputSize, opts_.inputSize, CV_8UC3, cv::Scalar::all(0));
+        cv::dnn::blobFromImage(probe, blob_, 1 / 255.0, cv::Size(), cv::Scalar(), true, false);
+        net_.setInput(blob_);
+        net_.forward(outputs_, outNames_);
+    } catch (cv::Exception& e) {
+        qDebug() << "[CascadeGate] Gate model load failed:" << e.what();
+        return;
+    }
+    if (outputs_.empty()) {
+        qDebug() << "[CascadeGate] Gate model has no output.";
+        return;
+    }
+    const cv::Mat& out = outputs_[0];
+    if (out.dims == 3) {
+        // nano 检测器的每个类别都要能在 coco.names 中找到
+        const int gateClasses = out.size[2] - 5;
+        if (gateClasses <= 0 || size_t(gateClasses) > classNames.size()) {
+            qDebug() << "[CascadeGate] Gate detector has" << gateClasses << "classes but only"
+                     << classNames.size() << "class names, cascade disabled.";
+            return;
+        }
+    } else if (out.total() == 0) {
+        qDebug() << "[CascadeGate] Unsupported gate output shape.";
+        return;
+    }
+
+    // 预先计算每个类别是否与垃圾分类相关
+    relevant_.resize(classNames.size());
+    for (size_t c = 0; c < classNames.size(); ++c)
+        relevant_[c] = CocoMap::getGarbageType(classNames[c]) != "continue";
+    loaded_ = true;
+}
+
+// 门控：分数达到阈值则通过并重置保持帧数，否则在保持期内继续通过
+bool CascadeGate::pass(const cv::Mat& frame, float* scoreOut)
+{
+    ++stats_.frames;
+    if (!loaded_) {
+        // 第一阶段不可用时退化为每帧完整检测
+        ++stats_.passed;
+        return true;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    float s = 0;
+    try {
+        cv::dnn::blobFromImage(frame, blob_, 1 / 255.0, cv::Size(opts_.inputSize, opts_.inputSize), cv::Scalar(), true, false);
+        net_.setInput(blob_);
+        net_.forward(outputs_, outNames_);
+        s = outputs_.empty() ? 1.0f : score(outputs_[0]);
+    } catch (cv::Exception& e) {
+        qDebug() << "[CascadeGate] Gate inference error:" << e.what();
+        s = 1.0f; // 出错时不跳过完整检测
+    }
+    stats_.gateMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (scoreOut)
+        *scoreOut = s;
+    if (s >= opts_.gateThreshold)
+        holdLeft_ = opts_.holdFrames + 1;
+    if (holdLeft_ > 0) {
+        --holdLeft_;
+        ++stats_.passed;
+        return true;
+    }
+    return false;
+}
+
+void CascadeGate::recordFullRun(double ms)
+{
+    ++stats_.fullRuns;
+    stats_.fullMs += ms;
+}
+
+float CascadeGate::score(const cv::Mat& out) const
+{
+    const float* data = (const float*)out.data;
+    if (out.dims == 3) {
+        // nano 检测器：[1, N, 5+C]
+        int numProposals = out.size[1];
+        int dims = out.size[2];
+        float best = 0;
+        for (int i = 0; i < numProposals; ++i, data += dims) {
+            float obj = data[4];
+            if (obj <= best)
+                continue; // obj × cls 不可能超过当前最大值
+            for (int c = 5; c < dims; ++c) {
+                size_t cls = size_t(c - 5);
+                if (cls < relevant_.size() && relevant_[cls])
+                    best = std::max(best, obj * data[c]);
+            }
+            if (best >= opts_.gateThreshold)
+                return best; // 已足以通过门控，提前结束
+        }
+        return best;
+    }
+
+    // 分类器：[1, C]，第0类为“无垃圾”
+    int numClasses = int(out.total());
+    if (numClasses == 1)
+        return data[0];
+    return *std::max_element(data + 1, data + numClasses);
+}
+
+void CascadeGate::logStats() const
+{
+    double gateAvg = stats_.frames ? stats_.gateMs / stats_.frames : 0;
+    double fullAvg = stats_.fullRuns ? stats_.fullMs / stats_.fullRuns : 0;
+    qDebug() << "[CascadeGate] passed:" << quint64(stats_.passed) << "/" << quint64(stats_.frames)
+             << QString("(%1%)").arg(stats_.runRatio() * 100, 0, 'f', 1)
+             << "full runs:" << quint64(stats_.fullRuns) << "gate avg ms:" << gateAvg << "full avg ms:" << fullAvg
+             << "saved ms:" << stats_.savedMs();
+}
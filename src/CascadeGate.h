@@ -0,0 +1,78 @@
+#ifndef CASCADEGATE_H
+#define CASCADEGATE_H
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+// 两级级联配置
+struct CascadeOptions {
+    std::string gateModelPath; // 第一阶段小模型（ONNX），空则不启用级联
+    int inputSize = 192; // 第一阶段输入尺寸（160~256，32 的倍数）
+    float gateThreshold = 0.25f; // 门控分数达到该值才运行完整检测
+    int holdFrames = 5; // 门控通过后继续运行完整检测的帧数，避免目标短暂漏检
+    bool enabled() const { return !gateModelPath.empty(); }
+};
+
+// 级联统计
+struct CascadeStats {
+    uint64_t frames = 0; // 经过门控的帧数
+    uint64_t passed = 0; // 门控通过（需要完整检测）的帧数
+    uint64_t fullRuns = 0; // 完整检测实际完成的次数（recordFullRun 计数）
+    double gateMs = 0; // 第一阶段累计耗时
+    double fullMs = 0; // 完整检测累计耗时
+    // 门控通过比例
+    double runRatio() const { return frames ? double(passed) / frames : 0; }
+    // 估计节省的时间：跳过的帧按完整检测平均耗时计，扣除第一阶段开销
+    double savedMs() const
+    {
+        double avgFull = fullRuns ? fullMs / fullRuns : 0;
+        return double(frames - passed) * avgFull - gateMs;
+    }
+};
+
+// CascadeGate 类：用小模型判断当前帧是否可能含有垃圾目标，决定是否运行完整 YOLOv5s 检测
+//
+// 第一阶段模型按输出形状自动识别：
+//   三维输出 [1, N, 5+C]：nano 检测器（如 yolov5n），分数为 objectness × 最大“非 continue 类别”分数；
+//   二维输出 [1, C]：分类器，第0类为“无垃圾”，分数为其余类别的最大概率（C==1 时直接取该值）。
+// 输入与 YOLOv5 相同：RGB，归一化到 [0, 1]。
+class CascadeGate {
+public:
+    // classNames 为 coco.names 类别名，用于判断检测器输出的类别是否与垃圾分类相关
+    CascadeGate(const CascadeOptions& opts, const std::vector<std::string>& classNames, bool useCuda = true);
+
+    // 模型加载成功、输入尺寸合法且类别名足够时为 true，否则不应启用级联
+    bool isLoaded() const { return loaded_; }
+    // 运行第一阶段，返回是否需要运行完整检测；score 非空时填入门控分数
+    bool pass(const cv::Mat& frame, float* score = nullptr);
+    // 记录一次完成的完整检测及其耗时（检测失败时不调用）
+    void recordFullRun(double ms);
+    const CascadeStats& stats() const { return stats_; }
+    // 清零统计和保持状态（如预热之后），下一帧只按门控分数决定是否运行完整检测
+    void reset()
+    {
+        stats_ = CascadeStats();
+        holdLeft_ = 0;
+    }
+    // 输出统计信息
+    void logStats() const;
+
+private:
+    // 计算门控分数
+    float score(const cv::Mat& out) const;
+
+    CascadeOptions opts_;
+    cv::dnn::Net net_; // 第一阶段网络
+    std::vector<std::string> outNames_; // 输出层名称
+    std::vector<bool> relevant_; // 各类别是否属于需要分拣的垃圾
+    bool loaded_;
+    int holdLeft_; // 剩余保持帧数
+    CascadeStats stats_;
+
+    // 每帧复用的缓冲区
+    cv::Mat blob_;
+    std::vector<cv::Mat> outputs_;
+};
+
+#endif // CASCADEGATE_H
@@ -1,12 +1,25 @@
 #ifndef DETECTOR_H
 #define DETECTOR_H
 
+#include "CascadeGate.h"
+#include "EventPublisher.h"
+#include "FrameBusWriter.h"
+#include "YoloEngine.h"
 #include <QImage>
 #include <QThread>
+#include <memory>
 #include <opencv2/opencv.hpp>
 #include <string>
 #include <vector>
 
+// 采集配置：录制摄像头帧或从录制文件回放
+struct CaptureOptions {
+    std::string recordPath; // 非空时将摄像头帧录制到该文件（已存在时另建带编号的文件，不覆盖）
+    bool recordMjpeg = false; // 录制时使用MJPEG编码（否则为原始像素）
+    std::string replayPath; // 非空时从该录制文件回放，代替摄像头
+    bool replayRealtime = true; // 回放时按原始时间间隔（否则全速回放）
+};
+
 // Detector 类：基于OpenCV DNN和QThread实现的目标检测器
 class Detector : public QThread {
     Q_OBJECT
@@ -18,6 +31,14 @@ public:
 
     // 设置检测置信度阈值
     void setThreshold(float t);
+    // 设置采集配置（需在 start() 之前调用）
+    void setCaptureOptions(const CaptureOptions& opts);
+    // 设置检测事件发布配置（需在 start() 之前调用）
+    void setEventOptions(const EventOptions& opts);
+    // 设置帧总线配置，启用后每帧图像和检测结果写入共享内存（需在 start() 之前调用）
+    void setFrameBusOptions(const FrameBusOptions& opts);
+    // 设置两级级联配置，启用后先用小模型判断是否运行完整检测（需在 start() 之前调用）
+    void setCascadeOptions(const CascadeOptions& opts);
     // 停止检测线程
     void stop();
 
@@ -33,10 +54,13 @@ protected:
     void run() override;
 
 private:
-    cv::dnn::Net net_;                   // OpenCV DNN网络对象
+    YoloEngine engine_;                  // 单帧检测流程（预处理/前向/解码/NMS）
     float threshold_;                    // 检测置信度阈值
     bool running_;                       // 线程运行标志
-    std::vector<std::string> classNames_;// coco.names类别名列表
+    CaptureOptions capture_;             // 采集配置（录制/回放）
+    std::unique_ptr<EventPublisher> events_; // 检测事件发布器（未启用时为空）
+    std::unique_ptr<FrameBusWriter> bus_; // 帧总线写端（未启用时为空）
+    std::unique_ptr<CascadeGate> gate_; // 级联第一阶段（未启用时为空）
 };
 
 #endif // DETECTOR_H
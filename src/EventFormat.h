@@ -0,0 +1,105 @@
+#ifndef EVENTFORMAT_H
+#define EVENTFORMAT_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// 检测事件流格式定义（发布端 EventPublisher 与参考消费端 EventConsumer 共用）
+//
+// Unix 域套接字：字节流，每条事件为一个 EventRecord（二进制）或一行 JSON（JSON-lines）。
+// 共享内存环形缓冲区：ShmHeader + ShmSlot[slotCount]，每个槽用版本号做序列锁，
+//   写入中 version = 2*seq+1，写完 version = 2*seq+2；读端版本号前后一致才算读到完整记录。
+namespace EventFormat {
+
+const uint32_t kRecordMagic = 0x54564547; // "GEVT"
+const uint32_t kShmMagic = 0x4D485347; // "GSHM"
+const uint16_t kVersion = 1;
+
+// 垃圾分类编码
+enum Category : uint8_t {
+    Continue = 0, // 非垃圾目标
+    Recyclable = 1,
+    Food = 2,
+    Hazardous = 3,
+    Residual = 4
+};
+
+// 单条检测事件（二进制格式，固定64字节）
+struct EventRecord {
+    uint32_t magic; // kRecordMagic
+    uint16_t version; // kVersion
+    uint8_t category; // Category
+    uint8_t reserved0;
+    uint64_t seq; // 发布序号，从1开始递增
+    int64_t timestampUs; // 帧采集时间戳（微秒，系统时钟）
+    uint64_t frameId; // 帧序号
+    uint32_t trackId; // 跟踪编号
+    int32_t classId; // COCO 类别序号
+    float conf; // 置信度
+    int32_t x, y, w, h; // 原图坐标下的检测框
+    uint32_t reserved1;
+};
+
+// 共享内存环形缓冲区头
+struct ShmHeader {
+    uint32_t magic; // kShmMagic
+    uint16_t version; // kVersion
+    uint16_t reserved;
+    uint64_t slotCount; // 槽数量
+    std::atomic<uint64_t> writeSeq; // 已完整写入的最大序号
+    uint8_t pad[40]; // 填充到缓存行，避免与槽伪共享
+};
+
+// 共享内存环形缓冲区槽
+struct ShmSlot {
+    std::atomic<uint64_t> version; // 序列锁版本号
+    uint8_t pad[56];
+    EventRecord record;
+};
+
+static_assert(sizeof(EventRecord) == 64, "EventRecord layout");
+static_assert(sizeof(ShmHeader) == 64, "ShmHeader layout");
+static_assert(sizeof(ShmSlot) == 128, "ShmSlot layout");
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "shared-memory atomics must be lock-free");
+
+// 由 CocoMap 的分类字符串得到分类编码
+inline Category categoryCode(const std::string& type)
+{
+    if (type == "Recyclable waste")
+        return Recyclable;
+    if (type == "Food waste")
+        return Food;
+    if (type == "Hazardous waste")
+        return Hazardous;
+    if (type == "Residual waste")
+        return Residual;
+    return Continue;
+}
+
+// 分类编码对应的分类字符串
+inline const char* categoryName(uint8_t code)
+{
+    switch (code) {
+    case Recyclable:
+        return "Recyclable waste";
+    case Food:
+        return "Food waste";
+    case Hazardous:
+        return "Hazardous waste";
+    case Residual:
+        return "Residual waste";
+    default:
+        return "continue";
+    }
+}
+
+// 共享内存总大小
+inline size_t shmSize(uint64_t slotCount)
+{
+    return sizeof(ShmHeader) + slotCount * sizeof(ShmSlot);
+}
+
+} // namespace EventFormat
+
+#endif // EVENTFORMAT_H
@@ -0,0 +1,416 @@
+#include "EventPublisher.h"
+#include <QDebug>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iterator>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace EventFormat;
+
+namespace {
+const int kDrainTimeoutMs = 500; // 退出时等待客户端收完数据的最长时间
+
+// 追加 JSON 字符串内容：转义引号、反斜杠和控制字符
+void appendJsonEscaped(std::string& buf, const std::string& s)
+{
+    for (char ch : s) {
+        switch (ch) {
+        case '"':
+            buf += "\\\"";
+            break;
+        case '\\':
+            buf += "\\\\";
+            break;
+        case '\n':
+            buf += "\\n";
+            break;
+        case '\r':
+            buf += "\\r";
+            break;
+        case '\t':
+            buf += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(ch) < 0x20) {
+                char esc[8];
+                std::snprintf(esc, sizeof(esc), "\\u%04x", static_cast<unsigned char>(ch));
+                buf += esc;
+            } else {
+                buf += ch;
+            }
+        }
+    }
+}
+}
+
+EventPublisher::EventPublisher(const EventOptions& opts)
+    : opts_(opts)
+    , stopping_(false)
+    , wakeFd_(-1)
+    , listenFd_(-1)
+    , shmFd_(-1)
+    , shm_(nullptr)
+    , slots_(nullptr)
+    , seq_(0)
+    , published_(0)
+    , queueDropped_(0)
+    , clientDropped_(0)
+{
+    if (!opts_.shmName.empty())
+        openShm();
+    if (!opts_.socketPath.empty() && openSocket()) {
+        wakeFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeFd_ >= 0) {
+            writer_ = std::thread(&EventPublisher::writerLoop, this);
+        } else {
+            qDebug() << "[EventPublisher] eventfd failed:" << std::strerror(errno);
+            ::close(listenFd_);
+            ::unlink(opts_.socketPath.c_str());
+            listenFd_ = -1;
+        }
+    }
+}
+
+EventPublisher::~EventPublisher()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake();
+    if (writer_.joinable())
+        writer_.join();
+    if (wakeFd_ >= 0)
+        ::close(wakeFd_);
+
+    for (Client& c : clients_)
+        ::close(c.fd);
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        ::unlink(opts_.socketPath.c_str());
+    }
+    if (shm_) {
+        ::munmap(shm_, shmSize(opts_.shmSlots));
+        ::shm_unlink(opts_.shmName.c_str());
+    }
+    if (shmFd_ >= 0)
+        ::close(shmFd_);
+    qDebug() << "[EventPublisher] Closed. published:" << quint64(published_)
+             << "queue drops:" << quint64(queueDropped_) << "client drops:" << quint64(clientDropped_);
+}
+
+// 创建非阻塞监听套接字
+bool EventPublisher::openSocket()
+{
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (opts_.socketPath.size() >= sizeof(addr.sun_path)) {
+        qDebug() << "[EventPublisher] Socket path too long:" << QString::fromStdString(opts_.socketPath);
+        return false;
+    }
+    std::strcpy(addr.sun_path, opts_.socketPath.c_str());
+
+    listenFd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd_ < 0) {
+        qDebug() << "[EventPublisher] socket() failed:" << std::strerror(errno);
+        return false;
+    }
+    ::unlink(opts_.socketPath.c_str()); // 清理上次残留的套接字文件
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+        || ::listen(listenFd_, 8) != 0) {
+        qDebug() << "[EventPublisher] bind/listen failed:" << std::strerror(errno);
+        ::close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+    qDebug() << "[EventPublisher] Listening on:" << QString::fromStdString(opts_.socketPath);
+    return true;
+}
+
+// 创建并映射共享内存环形缓冲区
+bool EventPublisher::openShm()
+{
+    shmFd_ = ::shm_open(opts_.shmName.c_str(), O_CREAT | O_RDWR, 0644);
+    if (shmFd_ < 0) {
+        qDebug() << "[EventPublisher] shm_open failed:" << std::strerror(errno);
+        return false;
+    }
+    size_t size = shmSize(opts_.shmSlots);
+    void* p = MAP_FAILED;
+    if (::ftruncate(shmFd_, off_t(size)) == 0)
+        p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd_, 0);
+    if (p == MAP_FAILED) {
+        qDebug() << "[EventPublisher] ftruncate/mmap failed:" << std::strerror(errno);
+        ::close(shmFd_);
+        ::shm_unlink(opts_.shmName.c_str());
+        shmFd_ = -1;
+        return false;
+    }
+    std::memset(p, 0, size);
+    shm_ = static_cast<ShmHeader*>(p);
+    slots_ = reinterpret_cast<ShmSlot*>(shm_ + 1);
+    shm_->version = kVersion;
+    shm_->slotCount = opts_.shmSlots;
+    shm_->writeSeq.store(0, std::memory_order_relaxed);
+    // magic 最后写入，读端见到 magic 即可认为头部有效
+    std::atomic_thread_fence(std::memory_order_release);
+    shm_->magic = kShmMagic;
+    qDebug() << "[EventPublisher] Shared memory ring:" << QString::fromStdString(opts_.shmName)
+             << "slots:" << quint64(opts_.shmSlots);
+    return true;
+}
+
+// 序列锁写入一个槽，覆盖最旧的数据，永不阻塞
+void EventPublisher::writeShm(const EventRecord& rec)
+{
+    ShmSlot& slot = slots_[rec.seq % opts_.shmSlots];
+    slot.version.store(2 * rec.seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.record = rec;
+    slot.version.store(2 * rec.seq + 2, std::memory_order_release);
+    shm_->writeSeq.store(rec.seq, std::memory_order_release);
+}
+
+// 发布事件：写共享内存并入队，队列满时按丢弃策略处理
+void EventPublisher::publish(EventRecord rec, const std::string& label)
+{
+    rec.magic = kRecordMagic;
+    rec.version = kVersion;
+    rec.seq = ++seq_;
+    ++published_;
+
+    if (shm_)
+        writeShm(rec);
+    if (listenFd_ < 0)
+        return;
+
+    bool notify = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.size() >= opts_.queueCapacity) {
+            ++queueDropped_;
+            if (opts_.dropPolicy == EventDropPolicy::DropNewest)
+                return;
+            queue_.pop_front();
+        }
+        queue_.push_back({ rec, label });
+        // 队列由空变为非空时唤醒写线程开始计时，攒满一批时唤醒立即发送
+        notify = queue_.size() == 1 || queue_.size() == opts_.batchSize;
+    }
+    if (notify)
+        wake();
+}
+
+// 唤醒写线程（eventfd 计数累加，写线程读取后清零）
+void EventPublisher::wake()
+{
+    if (wakeFd_ < 0)
+        return;
+    uint64_t one = 1;
+    ssize_t n = ::write(wakeFd_, &one, sizeof(one));
+    (void)n;
+}
+
+// 写线程：攒批 -> 编码 -> 发送给所有客户端。
+// 无事件时阻塞在 ppoll 上，由 wakeFd_（新事件/停止）、listenFd_（新连接）或客户端可写唤醒；
+// 只有队列中有不足一批的事件时才设超时，到期后发送
+void EventPublisher::writerLoop()
+{
+    std::vector<Pending> batch;
+    std::string buf;
+    const auto interval = std::chrono::microseconds(opts_.flushIntervalUs);
+    bool partial = false; // 队列中有未满一批的事件，等待 deadline 到期
+    std::chrono::steady_clock::time_point deadline;
+
+    for (;;) {
+        bool stopping;
+        size_t queued;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping = stopping_;
+            queued = queue_.size();
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (queued == 0) {
+            partial = false;
+        } else if (!partial) {
+            partial = true;
+            deadline = now + interval;
+        }
+
+        // 停止时把队列中剩余的事件全部发出，不丢弃关机前最后几帧的事件
+        if (stopping || queued >= opts_.batchSize || (partial && now >= deadline)) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                batch.assign(std::make_move_iterator(queue_.begin()), std::make_move_iterator(queue_.end()));
+                queue_.clear();
+            }
+            partial = false;
+            if (!batch.empty())
+                sendBatch(batch, buf);
+        }
+        if (stopping) {
+            drainClients();
+            return;
+        }
+        waitForWork(partial ? std::chrono::duration_cast<std::chrono::microseconds>(deadline - now).count() : -1);
+    }
+}
+
+// 编码一批事件并追加到每个客户端的发送缓冲区，随后尽量发出
+void EventPublisher::sendBatch(const std::vector<Pending>& batch, std::string& buf)
+{
+    if (clients_.empty())
+        return;
+    buf.clear();
+    encode(batch, buf);
+    for (size_t i = 0; i < clients_.size();) {
+        Client& c = clients_[i];
+        // 慢客户端：缓冲区超过上限时整批丢弃，保证记录边界完整
+        if (c.out.size() + buf.size() > opts_.clientBufferBytes)
+            clientDropped_ += batch.size();
+        else
+            c.out += buf;
+        if (!flushClient(c)) {
+            dropClient(i);
+            continue;
+        }
+        ++i;
+    }
+}
+
+// 等待新事件、新连接或客户端可写；timeoutUs < 0 表示无限等待
+void EventPublisher::waitForWork(int64_t timeoutUs)
+{
+    std::vector<pollfd> fds;
+    fds.reserve(2 + clients_.size());
+    fds.push_back({ wakeFd_, POLLIN, 0 });
+    fds.push_back({ listenFd_, POLLIN, 0 });
+    // 只对有未发数据的客户端关心可写；POLLHUP/POLLERR 总会上报，用于发现断开
+    for (const Client& c : clients_)
+        fds.push_back({ c.fd, short(c.out.empty() ? 0 : POLLOUT), 0 });
+
+    timespec ts;
+    if (timeoutUs >= 0) {
+        ts.tv_sec = time_t(timeoutUs / 1000000);
+        ts.tv_nsec = long(timeoutUs % 1000000) * 1000;
+    }
+    if (::ppoll(fds.data(), fds.size(), timeoutUs >= 0 ? &ts : nullptr, nullptr) <= 0)
+        return;
+
+    if (fds[0].revents & POLLIN) {
+        uint64_t n;
+        while (::read(wakeFd_, &n, sizeof(n)) > 0) {
+        }
+    }
+    // 先处理已有客户端（倒序删除不影响前面的下标），再接受新连接
+    for (size_t i = clients_.size(); i-- > 0;) {
+        const short revents = fds[2 + i].revents;
+        if ((revents & (POLLHUP | POLLERR | POLLNVAL)) || ((revents & POLLOUT) && !flushClient(clients_[i])))
+            dropClient(i);
+    }
+    if (fds[1].revents & POLLIN)
+        acceptClients();
+}
+
+// 关闭前尽量把客户端缓冲区发完，最多等待 kDrainTimeoutMs，避免卡住的客户端阻塞退出
+void EventPublisher::drainClients()
+{
+    const auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(kDrainTimeoutMs);
+    for (;;) {
+        std::vector<pollfd> fds;
+        for (const Client& c : clients_) {
+            if (!c.out.empty())
+                fds.push_back({ c.fd, POLLOUT, 0 });
+        }
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(until - std::chrono::steady_clock::now()).count();
+        if (fds.empty() || left <= 0)
+            break;
+        ::poll(fds.data(), fds.size(), int(left));
+        for (size_t i = clients_.size(); i-- > 0;) {
+            if (!clients_[i].out.empty() && !flushClient(clients_[i]))
+                dropClient(i);
+        }
+    }
+    size_t pendingBytes = 0;
+    for (const Client& c : clients_)
+        pendingBytes += c.out.size();
+    if (pendingBytes)
+        qDebug() << "[EventPublisher] Shutdown: undelivered bytes:" << quint64(pendingBytes);
+}
+
+void EventPublisher::dropClient(size_t i)
+{
+    qDebug() << "[EventPublisher] Client disconnected.";
+    ::close(clients_[i].fd);
+    clients_.erase(clients_.begin() + long(i));
+}
+
+void EventPublisher::acceptClients()
+{
+    for (;;) {
+        int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+            return;
+        clients_.push_back({ fd, std::string() });
+        qDebug() << "[EventPublisher] Client connected. clients:" << clients_.size();
+    }
+}
+
+void EventPublisher::encode(const std::vector<Pending>& batch, std::string& buf) const
+{
+    if (opts_.format == EventStreamFormat::Binary) {
+        buf.reserve(batch.size() * sizeof(EventRecord));
+        for (const Pending& p : batch)
+            buf.append(reinterpret_cast<const char*>(&p.rec), sizeof(EventRecord));
+        return;
+    }
+    char head[192];
+    char tail[160];
+    for (const Pending& p : batch) {
+        const EventRecord& r = p.rec;
+        std::snprintf(head, sizeof(head),
+            "{\"seq\":%llu,\"ts_us\":%lld,\"frame\":%llu,\"track\":%u,\"class_id\":%d,\"label\":\"",
+            (unsigned long long)r.seq, (long long)r.timestampUs, (unsigned long long)r.frameId,
+            r.trackId, r.classId);
+        // 置信度按整数和四位小数分别输出：%f 受 LC_NUMERIC 影响（QCoreApplication 会调用 setlocale），
+        // 逗号作小数点的区域设置下会产生非法 JSON
+        const long long conf = std::isfinite(r.conf) ? std::llround(std::min(1.0f, std::max(0.0f, r.conf)) * 10000.0) : 0;
+        std::snprintf(tail, sizeof(tail),
+            "\",\"category\":\"%s\",\"conf\":%lld.%04lld,\"box\":[%d,%d,%d,%d]}\n",
+            categoryName(r.category), conf / 10000, conf % 10000, r.x, r.y, r.w, r.h);
+        buf += head;
+        appendJsonEscaped(buf, p.label);
+        buf += tail;
+    }
+}
+
+bool EventPublisher::flushClient(Client& c)
+{
+    size_t sent = 0;
+    while (sent < c.out.size()) {
+        ssize_t n = ::send(c.fd, c.out.data() + sent, c.out.size() - sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += size_t(n);
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if (n < 0 && errno == EINTR)
+            continue;
+        return false;
+    }
+    c.out.erase(0, sent);
+    return true;
+}
@@ -0,0 +1,116 @@
+#ifndef EVENTPUBLISHER_H
+#define EVENTPUBLISHER_H
+
+#include "EventFormat.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 套接字输出格式
+enum class EventStreamFormat {
+    JsonLines, // 每条事件一行 JSON
+    Binary // 每条事件一个 EventFormat::EventRecord
+};
+
+// 发送队列满时的丢弃策略
+enum class EventDropPolicy {
+    DropOldest, // 丢弃队列中最旧的事件
+    DropNewest // 丢弃新到的事件
+};
+
+// 事件发布配置
+struct EventOptions {
+    std::string socketPath; // Unix 域套接字路径，空则不启用
+    std::string shmName; // 共享内存名（如 /gc_events），空则不启用
+    EventStreamFormat format = EventStreamFormat::JsonLines; // 套接字输出格式
+    EventDropPolicy dropPolicy = EventDropPolicy::DropOldest; // 队列满时的丢弃策略
+    size_t queueCapacity = 1024; // 发送队列容量（事件数）
+    size_t batchSize = 32; // 攒够多少条立即发送
+    int flushIntervalUs = 1000; // 不足一批时的最长等待时间（微秒）
+    size_t clientBufferBytes = 256 * 1024; // 每个客户端未发出数据上限，超过则丢弃新批次
+    uint64_t shmSlots = 4096; // 共享内存环形缓冲区槽数
+    bool enabled() const { return !socketPath.empty() || !shmName.empty(); }
+};
+
+// EventPublisher 类：将检测事件非阻塞地发布到 Unix 域套接字和/或共享内存环形缓冲区
+//
+// publish() 在推理线程调用，只写共享内存并短暂加锁入队，从不等待 I/O；
+// 套接字的接受连接、编码和批量发送都在后台写线程完成，慢客户端只会丢数据，不会拖慢推理。
+class EventPublisher {
+public:
+    explicit EventPublisher(const EventOptions& opts);
+    // 析构函数：发出队列中剩余的事件（客户端最多等待 500ms），再停止写线程并释放套接字和共享内存
+    ~EventPublisher();
+    EventPublisher(const EventPublisher&) = delete;
+    EventPublisher& operator=(const EventPublisher&) = delete;
+
+    // 发布一条事件，seq 由发布器填写；label 为 COCO 类别名（JSON 格式使用）
+    void publish(EventFormat::EventRecord rec, const std::string& label);
+
+    // 统计：已发布、队列满丢弃、慢客户端丢弃的事件数
+    uint64_t publishedCount() const { return published_; }
+    uint64_t queueDropCount() const { return queueDropped_; }
+    uint64_t clientDropCount() const { return clientDropped_; }
+
+private:
+    // 待发送事件
+    struct Pending {
+        EventFormat::EventRecord rec;
+        std::string label;
+    };
+    // 已连接的客户端
+    struct Client {
+        int fd;
+        std::string out; // 未发出的数据
+    };
+
+    bool openSocket();
+    bool openShm();
+    void writeShm(const EventFormat::EventRecord& rec);
+    // 唤醒写线程
+    void wake();
+    // 后台写线程主循环
+    void writerLoop();
+    // 编码一批事件并发送给所有客户端
+    void sendBatch(const std::vector<Pending>& batch, std::string& buf);
+    // 阻塞等待新事件、新连接或客户端可写，timeoutUs < 0 为无限等待
+    void waitForWork(int64_t timeoutUs);
+    // 退出前尽量发完客户端缓冲数据
+    void drainClients();
+    // 关闭并移除第 i 个客户端
+    void dropClient(size_t i);
+    // 接受新连接（非阻塞）
+    void acceptClients();
+    // 将一批事件编码到 buf
+    void encode(const std::vector<Pending>& batch, std::string& buf) const;
+    // 尽量发出客户端缓冲数据，连接断开返回 false
+    bool flushClient(Client& c);
+
+    EventOptions opts_;
+
+    // 发送队列（推理线程写入，写线程取出）
+    std::mutex mutex_;
+    std::deque<Pending> queue_;
+    bool stopping_;
+    int wakeFd_; // eventfd，新事件或停止时唤醒写线程
+    std::thread writer_;
+
+    // Unix 域套接字
+    int listenFd_;
+    std::vector<Client> clients_;
+
+    // 共享内存环形缓冲区
+    int shmFd_;
+    EventFormat::ShmHeader* shm_;
+    EventFormat::ShmSlot* slots_;
+
+    uint64_t seq_; // 发布序号（仅推理线程访问）
+    std::atomic<uint64_t> published_;
+    std::atomic<uint64_t> queueDropped_;
+    std::atomic<uint64_t> clientDropped_;
+};
+
+#endif // EVENTPUBLISHER_H
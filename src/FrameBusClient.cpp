@@ -0,0 +1,78 @@
+#include "FrameBusClient.h"
+#include "FrameBusReader.h"
+#include <QDebug>
+
+namespace {
+const int STALE_MS = 2000; // 超过该时间没有新帧视为守护进程已退出
+}
+
+FrameBusClient::FrameBusClient(const std::string& name, float thresh)
+    : name_(name)
+    , threshold_(thresh)
+    , running_(false)
+{
+}
+
+// 析构函数：停止线程并等待结束
+FrameBusClient::~FrameBusClient()
+{
+    stop();
+    wait();
+}
+
+void FrameBusClient::setThreshold(float t)
+{
+    threshold_ = t;
+}
+
+void FrameBusClient::stop()
+{
+    running_ = false;
+}
+
+// 读取主循环：只取最新帧，像素直接从共享内存转换为 QImage，转换后校验未被覆盖
+void FrameBusClient::run()
+{
+    running_ = true;
+    qDebug() << "[FrameBusClient] Thread started, bus:" << QString::fromStdString(name_);
+    FrameBusReader reader;
+    FrameView view;
+
+    while (running_) {
+        // 守护进程未启动或已重启：重新映射（新守护进程会创建新的共享内存对象）
+        if (!reader.isOpen() || !reader.alive(STALE_MS)) {
+            if (!reader.open(name_) || !reader.alive(STALE_MS)) {
+                QThread::msleep(500);
+                continue;
+            }
+        }
+        if (!reader.next(view, true)) {
+            QThread::msleep(2);
+            continue;
+        }
+
+        // 按本地阈值过滤检测结果
+        std::vector<cv::Rect> boxes;
+        std::vector<float> confs;
+        std::vector<std::string> labels;
+        for (const Detection& d : view.dets) {
+            if (d.conf >= threshold_) {
+                boxes.push_back(d.box);
+                confs.push_back(d.conf);
+                labels.push_back(d.label);
+            }
+        }
+        if (boxes.empty() || view.image.empty() || view.image.type() != CV_8UC3)
+            continue;
+
+        QImage img(view.image.cols, view.image.rows, QImage::Format_RGB888);
+        cv::Mat rgb(img.height(), img.width(), CV_8UC3, img.bits(), size_t(img.bytesPerLine()));
+        cv::cvtColor(view.image, rgb, cv::COLOR_BGR2RGB);
+        if (!reader.validate(view)) {
+            // 转换期间槽被覆盖，丢弃该帧
+            continue;
+        }
+        emit detection(img, boxes, confs, labels);
+    }
+    qDebug() << "[FrameBusClient] Thread stopped.";
+}
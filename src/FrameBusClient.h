@@ -0,0 +1,42 @@
+#ifndef FRAMEBUSCLIENT_H
+#define FRAMEBUSCLIENT_H
+
+#include <QImage>
+#include <QThread>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+// FrameBusClient 类：连接检测守护进程的帧总线，发射与 Detector 相同的 detection 信号，
+// 界面进程无需加载模型或打开摄像头；守护进程重启后自动重连
+class FrameBusClient : public QThread {
+    Q_OBJECT
+public:
+    // 构造函数，name 为帧总线共享内存名，thresh 为本地显示阈值
+    FrameBusClient(const std::string& name, float thresh = 0.5f);
+    // 析构函数，安全停止线程
+    ~FrameBusClient();
+
+    // 设置本地置信度阈值（守护进程的检测阈值不变）
+    void setThreshold(float t);
+    // 停止读取线程
+    void stop();
+
+signals:
+    // 检测信号：与 Detector::detection 一致
+    void detection(const QImage& frame,
+        const std::vector<cv::Rect>& boxes,
+        const std::vector<float>& confs,
+        const std::vector<std::string>& labels);
+
+protected:
+    // QThread的主循环，轮询帧总线上的最新帧
+    void run() override;
+
+private:
+    std::string name_; // 帧总线共享内存名
+    float threshold_; // 本地置信度阈值
+    bool running_; // 线程运行标志
+};
+
+#endif // FRAMEBUSCLIENT_H
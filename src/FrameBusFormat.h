@@ -0,0 +1,83 @@
+#ifndef FRAMEBUSFORMAT_H
+#define FRAMEBUSFORMAT_H
+
+#include <atomic>
+#include <cstdint>
+
+// 帧总线共享内存布局（检测守进程 FrameBusWriter 写入，多个客户端 FrameBusReader 只读映射）
+//
+//   BusHeader
+//   Slot[slotCount]，每个槽 slotStride 字节：SlotHeader（含检测结果）+ 像素数据
+//
+// 每个槽用版本号做序列锁：写入中 version = 2*seq+1，写完 version = 2*seq+2。
+// 读端直接引用映射内存中的像素，用完后再次比对版本号，确认期间未被覆盖。
+namespace FrameBusFormat {
+
+const uint32_t kMagic = 0x53554247; // "GBUS"
+const uint16_t kVersion = 1;
+const uint32_t kMaxDetections = 64; // 每帧最多保存的检测数
+const uint64_t kAlign = 64;
+
+// 单个检测结果
+struct BusDetection {
+    int32_t x, y, w, h; // 原图坐标下的检测框
+    float conf; // 置信度
+    int32_t classId; // COCO 类别序号
+    char label[24]; // COCO 类别名（以0结尾，超长截断）
+};
+
+// 总线头
+struct BusHeader {
+    uint32_t magic; // kMagic
+    uint16_t version; // kVersion
+    uint16_t reserved0;
+    uint32_t slotCount; // 槽数量
+    uint32_t maxDetections; // kMaxDetections
+    uint64_t slotStride; // 每个槽的字节数
+    uint64_t frameCapacity; // 每个槽可容纳的最大像素字节数
+    std::atomic<uint64_t> writeSeq; // 已完整写入的最新帧序号（从1开始）
+    std::atomic<int64_t> heartbeatUs; // 写端最近一次发布的时间（微秒，系统时钟）
+    int32_t pid; // 守护进程 pid
+    uint8_t reserved1[12];
+};
+
+// 槽头，像素数据从槽起始偏移 alignUp(sizeof(SlotHeader)) 处开始
+struct SlotHeader {
+    std::atomic<uint64_t> version; // 序列锁版本号
+    uint64_t seq; // 帧序号
+    int64_t timestampUs; // 采集时间戳（微秒，系统时钟）
+    uint64_t frameId; // 检测线程内的帧编号
+    int32_t width, height, type; // 图像尺寸和 cv::Mat 类型
+    uint32_t step; // 每行字节数
+    uint64_t frameBytes; // 像素字节数，0 表示本帧未附带图像
+    uint32_t detCount; // 检测数
+    uint32_t reserved;
+    BusDetection dets[kMaxDetections];
+};
+
+static_assert(sizeof(BusDetection) == 48, "BusDetection layout");
+static_assert(sizeof(BusHeader) == kAlign, "BusHeader layout");
+static_assert(sizeof(SlotHeader) % kAlign == 0, "SlotHeader layout");
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "shared-memory atomics must be lock-free");
+
+// 向上对齐到 kAlign
+inline uint64_t alignUp(uint64_t n)
+{
+    return (n + kAlign - 1) / kAlign * kAlign;
+}
+
+// 每个槽的字节数
+inline uint64_t slotStride(uint64_t frameCapacity)
+{
+    return sizeof(SlotHeader) + alignUp(frameCapacity);
+}
+
+// 共享内存总大小
+inline uint64_t busSize(uint32_t slotCount, uint64_t frameCapacity)
+{
+    return sizeof(BusHeader) + uint64_t(slotCount) * slotStride(frameCapacity);
+}
+
+} // namespace FrameBusFormat
+
+#endif // FRAMEBUSFORMAT_H
@@ -0,0 +1,157 @@
+#include "FrameBusReader.h"
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace FrameBusFormat;
+
+FrameBusReader::FrameBusReader()
+    : fd_(-1)
+    , size_(0)
+    , base_(nullptr)
+    , header_(nullptr)
+    , next_(0)
+    , lost_(0)
+{
+}
+
+FrameBusReader::~FrameBusReader()
+{
+    close();
+}
+
+// 只读映射，并从当前最新帧开始读取
+bool FrameBusReader::open(const std::string& name)
+{
+    close();
+    fd_ = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd_ < 0)
+        return false;
+    struct stat st;
+    if (::fstat(fd_, &st) != 0 || uint64_t(st.st_size) < sizeof(BusHeader)) {
+        close();
+        return false;
+    }
+    size_ = uint64_t(st.st_size);
+    void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (p == MAP_FAILED) {
+        close();
+        return false;
+    }
+    base_ = static_cast<const uchar*>(p);
+    const BusHeader* h = reinterpret_cast<const BusHeader*>(base_);
+    if (h->magic != kMagic || h->version != kVersion || h->slotCount == 0
+        || busSize(h->slotCount, h->frameCapacity) > size_) {
+        qDebug() << "[FrameBusReader] Not a frame bus:" << QString::fromStdString(name);
+        close();
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    header_ = h;
+    next_ = header_->writeSeq.load(std::memory_order_acquire);
+    lost_ = 0;
+    qDebug() << "[FrameBusReader] Attached:" << QString::fromStdString(name) << "daemon pid:" << header_->pid;
+    return true;
+}
+
+void FrameBusReader::close()
+{
+    if (base_)
+        ::munmap(const_cast<uchar*>(base_), size_);
+    if (fd_ >= 0)
+        ::close(fd_);
+    fd_ = -1;
+    size_ = 0;
+    base_ = nullptr;
+    header_ = nullptr;
+}
+
+bool FrameBusReader::next(FrameView& view, bool latestOnly)
+{
+    if (!header_)
+        return false;
+    const uint64_t head = header_->writeSeq.load(std::memory_order_acquire);
+    if (head == 0 || head < next_)
+        return false;
+
+    // 写端可能正在写 head+1 所在的槽，按序读取时最旧的安全帧为 head-slotCount+2
+    uint64_t seq = next_;
+    const uint64_t window = header_->slotCount > 1 ? header_->slotCount - 1 : 1;
+    if (latestOnly || seq == 0) {
+        seq = head;
+    } else if (head - seq >= window) {
+        lost_ += head - window + 1 - seq;
+        seq = head - window + 1;
+    }
+
+    const uchar* slotBase = base_ + sizeof(BusHeader) + (seq % header_->slotCount) * header_->slotStride;
+    const SlotHeader* slot = reinterpret_cast<const SlotHeader*>(slotBase);
+    const uint64_t v = slot->version.load(std::memory_order_acquire);
+    if (v != 2 * seq + 2)
+        return false;
+
+    // 先拷出标量字段，整槽通过序列锁校验后再检查尺寸，最后才让 Mat 指向像素
+    view.seq = seq;
+    view.timestampUs = slot->timestampUs;
+    view.frameId = slot->frameId;
+    view.version = v;
+    view.slot = slot;
+    const int32_t width = slot->width;
+    const int32_t height = slot->height;
+    const int32_t type = slot->type;
+    const uint32_t step = slot->step;
+    const uint64_t frameBytes = slot->frameBytes;
+    uint32_t n = std::min<uint32_t>(slot->detCount, kMaxDetections);
+    view.dets.clear();
+    for (uint32_t i = 0; i < n; ++i) {
+        const BusDetection& d = slot->dets[i];
+        char label[sizeof(d.label)];
+        std::memcpy(label, d.label, sizeof(label));
+        label[sizeof(label) - 1] = '\0';
+        view.dets.push_back({ cv::Rect(d.x, d.y, d.w, d.h), d.conf, d.classId, label });
+    }
+    if (!validate(view))
+        return false;
+
+    view.image.release();
+    if (frameBytes > 0) {
+        if (!validFrame(width, height, type, step, frameBytes)) {
+            qDebug() << "[FrameBusReader] Bad frame header, skipped seq:" << quint64(seq);
+            next_ = seq + 1;
+            return false;
+        }
+        // Mat 头直接指向只读映射，任何写入都会触发段错误
+        view.image = cv::Mat(height, width, type, const_cast<uchar*>(slotBase + sizeof(SlotHeader)), step);
+    }
+    next_ = seq + 1;
+    return true;
+}
+
+// 图像必须完整落在槽内，类型合法，行宽不小于一行像素
+bool FrameBusReader::validFrame(int32_t width, int32_t height, int32_t type, uint32_t step, uint64_t frameBytes) const
+{
+    if (frameBytes > header_->frameCapacity || width <= 0 || height <= 0
+        || type != CV_MAT_TYPE(type) || CV_MAT_DEPTH(type) > CV_64F)
+        return false;
+    return step >= uint64_t(width) * CV_ELEM_SIZE(type) && uint64_t(step) * uint64_t(height) <= frameBytes;
+}
+
+bool FrameBusReader::validate(const FrameView& view) const
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return view.slot && view.slot->version.load(std::memory_order_relaxed) == view.version;
+}
+
+bool FrameBusReader::alive(int maxAgeMs) const
+{
+    if (!header_)
+        return false;
+    int64_t nowUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return nowUs - header_->heartbeatUs.load(std::memory_order_relaxed) <= int64_t(maxAgeMs) * 1000;
+}
@@ -0,0 +1,56 @@
+#ifndef FRAMEBUSREADER_H
+#define FRAMEBUSREADER_H
+
+#include "FrameBusFormat.h"
+#include "YoloEngine.h"
+#include <string>
+#include <vector>
+
+// 帧总线上的一帧：image 直接引用共享内存（只读映射，零拷贝），使用完毕后须调用 FrameBusReader::validate()
+struct FrameView {
+    uint64_t seq = 0; // 帧序号
+    int64_t timestampUs = 0; // 采集时间戳（微秒）
+    uint64_t frameId = 0; // 检测线程内的帧编号
+    cv::Mat image; // 图像（未附带图像时为空），只读
+    std::vector<Detection> dets; // 检测结果（已拷出，不受覆盖影响）
+    uint64_t version = 0; // 读取时的槽版本号
+    const FrameBusFormat::SlotHeader* slot = nullptr;
+};
+
+// FrameBusReader 类：只读映射检测守护进程发布的帧总线
+class FrameBusReader {
+public:
+    FrameBusReader();
+    // 析构函数，解除映射
+    ~FrameBusReader();
+    FrameBusReader(const FrameBusReader&) = delete;
+    FrameBusReader& operator=(const FrameBusReader&) = delete;
+
+    // 只读映射共享内存，失败返回 false（守护进程未启动等）
+    bool open(const std::string& name);
+    void close();
+    bool isOpen() const { return header_ != nullptr; }
+
+    // 读取一帧新数据：latestOnly 为 true 时跳到最新帧（界面显示），否则按序读取（日志记录）。
+    // 没有新帧或槽正在被写入时返回 false
+    bool next(FrameView& view, bool latestOnly);
+    // 确认 view 引用的槽在读取期间未被覆盖
+    bool validate(const FrameView& view) const;
+    // 写端是否在 maxAgeMs 毫秒内发布过数据
+    bool alive(int maxAgeMs) const;
+    // 按序读取时因读得太慢被覆盖的帧数
+    uint64_t lostCount() const { return lost_; }
+
+private:
+    // 检查槽头中的图像尺寸、类型和行宽是否落在槽内
+    bool validFrame(int32_t width, int32_t height, int32_t type, uint32_t step, uint64_t frameBytes) const;
+
+    int fd_;
+    uint64_t size_;
+    const uchar* base_;
+    const FrameBusFormat::BusHeader* header_;
+    uint64_t next_; // 下一个要读的帧序号
+    uint64_t lost_;
+};
+
+#endif // FRAMEBUSREADER_H
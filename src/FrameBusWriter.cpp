@@ -0,0 +1,117 @@
+#include "FrameBusWriter.h"
+#include <QDebug>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace FrameBusFormat;
+
+// 创建共享内存：先删除同名旧对象，已映射旧对象的客户端不受影响，重连后即可看到新总线
+FrameBusWriter::FrameBusWriter(const FrameBusOptions& opts)
+    : opts_(opts)
+    , fd_(-1)
+    , size_(busSize(opts.slots, opts.frameCapacity))
+    , base_(nullptr)
+    , header_(nullptr)
+    , seq_(0)
+{
+    ::shm_unlink(opts_.name.c_str());
+    fd_ = ::shm_open(opts_.name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd_ < 0) {
+        qDebug() << "[FrameBusWriter] shm_open failed:" << std::strerror(errno);
+        return;
+    }
+    void* p = MAP_FAILED;
+    if (::ftruncate(fd_, off_t(size_)) == 0)
+        p = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (p == MAP_FAILED) {
+        qDebug() << "[FrameBusWriter] ftruncate/mmap failed:" << std::strerror(errno);
+        ::close(fd_);
+        ::shm_unlink(opts_.name.c_str());
+        fd_ = -1;
+        return;
+    }
+    // ftruncate 得到的内存已清零，只需填写头部，magic 最后写入
+    base_ = static_cast<uchar*>(p);
+    header_ = reinterpret_cast<BusHeader*>(base_);
+    header_->version = kVersion;
+    header_->slotCount = opts_.slots;
+    header_->maxDetections = kMaxDetections;
+    header_->slotStride = slotStride(opts_.frameCapacity);
+    header_->frameCapacity = opts_.frameCapacity;
+    header_->pid = int32_t(::getpid());
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic = kMagic;
+    qDebug() << "[FrameBusWriter] Frame bus:" << QString::fromStdString(opts_.name)
+             << "slots:" << opts_.slots << "bytes:" << quint64(size_);
+}
+
+FrameBusWriter::~FrameBusWriter()
+{
+    if (base_) {
+        ::munmap(base_, size_);
+        ::shm_unlink(opts_.name.c_str());
+    }
+    if (fd_ >= 0)
+        ::close(fd_);
+}
+
+// 序列锁写入下一个槽，覆盖最旧的帧，永不等待读端
+void FrameBusWriter::publish(const cv::Mat& frame, int64_t timestampUs, uint64_t frameId,
+    const std::vector<Detection>& dets)
+{
+    if (!header_)
+        return;
+    const uint64_t seq = ++seq_;
+    uchar* slotBase = base_ + sizeof(BusHeader) + (seq % opts_.slots) * header_->slotStride;
+    SlotHeader* slot = reinterpret_cast<SlotHeader*>(slotBase);
+    uchar* pixels = slotBase + sizeof(SlotHeader);
+
+    slot->version.store(2 * seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->seq = seq;
+    slot->timestampUs = timestampUs;
+    slot->frameId = frameId;
+    slot->width = frame.cols;
+    slot->height = frame.rows;
+    slot->type = frame.type();
+    slot->step = uint32_t(frame.cols * frame.elemSize());
+    uint64_t bytes = uint64_t(slot->step) * frame.rows;
+    if (bytes <= opts_.frameCapacity) {
+        // 逐行拷贝以兼容非连续 Mat，槽内始终为紧凑存储
+        if (frame.isContinuous()) {
+            std::memcpy(pixels, frame.data, bytes);
+        } else {
+            for (int y = 0; y < frame.rows; ++y)
+                std::memcpy(pixels + uint64_t(y) * slot->step, frame.ptr(y), slot->step);
+        }
+        slot->frameBytes = bytes;
+    } else {
+        slot->frameBytes = 0;
+    }
+
+    uint32_t n = uint32_t(std::min<size_t>(dets.size(), kMaxDetections));
+    for (uint32_t i = 0; i < n; ++i) {
+        BusDetection& d = slot->dets[i];
+        d.x = dets[i].box.x;
+        d.y = dets[i].box.y;
+        d.w = dets[i].box.width;
+        d.h = dets[i].box.height;
+        d.conf = dets[i].conf;
+        d.classId = dets[i].classId;
+        std::strncpy(d.label, dets[i].label.c_str(), sizeof(d.label) - 1);
+        d.label[sizeof(d.label) - 1] = '\0';
+    }
+    slot->detCount = n;
+
+    slot->version.store(2 * seq + 2, std::memory_order_release);
+    header_->writeSeq.store(seq, std::memory_order_release);
+    int64_t nowUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    header_->heartbeatUs.store(nowUs, std::memory_order_relaxed);
+}
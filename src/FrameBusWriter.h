@@ -0,0 +1,40 @@
+#ifndef FRAMEBUSWRITER_H
+#define FRAMEBUSWRITER_H
+
+#include "FrameBusFormat.h"
+#include "YoloEngine.h"
+#include <string>
+#include <vector>
+
+// 帧总线配置
+struct FrameBusOptions {
+    std::string name; // 共享内存名（如 /gc_frames），空则不启用
+    uint32_t slots = 4; // 环形缓冲区槽数
+    uint64_t frameCapacity = 1920 * 1080 * 3; // 每帧最大像素字节数
+    bool enabled() const { return !name.empty(); }
+};
+
+// FrameBusWriter 类：将每帧图像和检测结果写入共享内存环形缓冲区，供多个本地客户端只读映射
+class FrameBusWriter {
+public:
+    explicit FrameBusWriter(const FrameBusOptions& opts);
+    // 析构函数，解除映射并删除共享内存名
+    ~FrameBusWriter();
+    FrameBusWriter(const FrameBusWriter&) = delete;
+    FrameBusWriter& operator=(const FrameBusWriter&) = delete;
+
+    bool isOpen() const { return header_ != nullptr; }
+    // 发布一帧；超过 frameCapacity 的图像只发布检测结果
+    void publish(const cv::Mat& frame, int64_t timestampUs, uint64_t frameId,
+        const std::vector<Detection>& dets);
+
+private:
+    FrameBusOptions opts_;
+    int fd_; // 共享内存文件描述符
+    uint64_t size_; // 映射长度
+    uchar* base_; // 映射基址
+    FrameBusFormat::BusHeader* header_;
+    uint64_t seq_; // 最新帧序号
+};
+
+#endif // FRAMEBUSWRITER_H
@@ -0,0 +1,155 @@
+#include "FrameRecorder.h"
+#include <QDebug>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace CaptureFormat;
+
+FrameRecorder::FrameRecorder()
+    : codec_(Raw)
+    , jpegQuality_(90)
+    , offset_(0)
+{
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    close();
+}
+
+// 以 O_EXCL 创建一个尚不存在的文件：先试 path，再依次试 name-1.ext、name-2.ext……
+// 保证重新开始检测时不会截断之前的录制
+namespace {
+std::string createUnique(const std::string& path)
+{
+    std::string::size_type slash = path.find_last_of('/');
+    std::string::size_type dot = path.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        dot = path.size();
+    for (int n = 0; n < 10000; ++n) {
+        std::string candidate = n == 0 ? path : path.substr(0, dot) + "-" + std::to_string(n) + path.substr(dot);
+        int fd = ::open(candidate.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (fd >= 0) {
+            ::close(fd);
+            return candidate;
+        }
+        if (errno != EEXIST)
+            break;
+    }
+    return std::string();
+}
+}
+
+// 创建录制文件并写入文件头
+bool FrameRecorder::open(const std::string& path, Codec codec, int jpegQuality)
+{
+    close();
+    path_ = createUnique(path);
+    if (!path_.empty())
+        ofs_.open(path_, std::ios::binary); // 文件刚由 createUnique 创建，为空
+    if (!ofs_.is_open()) {
+        qDebug() << "[FrameRecorder] Cannot create:" << QString::fromStdString(path);
+        return false;
+    }
+    codec_ = codec;
+    jpegQuality_ = jpegQuality;
+    offset_ = 0;
+    index_.clear();
+
+    FileHeader fh;
+    std::memset(&fh, 0, sizeof(fh));
+    fh.magic = kFileMagic;
+    fh.version = kVersion;
+    ofs_.write(reinterpret_cast<const char*>(&fh), sizeof(fh));
+    offset_ += sizeof(fh);
+    pad();
+
+    qDebug() << "[FrameRecorder] Recording to:" << QString::fromStdString(path_)
+             << "codec:" << (codec_ == Mjpeg ? "MJPEG" : "RAW");
+    return bool(ofs_);
+}
+
+// 追加一帧：记录头 + payload + 对齐填充
+bool FrameRecorder::write(const cv::Mat& frame, int64_t timestampUs)
+{
+    if (!ofs_.is_open() || frame.empty())
+        return false;
+
+    RecordHeader rh;
+    std::memset(&rh, 0, sizeof(rh));
+    rh.magic = kRecordMagic;
+    rh.codec = codec_;
+    rh.width = frame.cols;
+    rh.height = frame.rows;
+    rh.type = frame.type();
+    rh.step = uint32_t(frame.cols * frame.elemSize());
+    rh.timestampUs = timestampUs;
+
+    if (codec_ == Mjpeg) {
+        std::vector<int> params = { cv::IMWRITE_JPEG_QUALITY, jpegQuality_ };
+        if (!cv::imencode(".jpg", frame, jpegBuf_, params)) {
+            qDebug() << "[FrameRecorder] imencode failed.";
+            return false;
+        }
+        rh.payloadSize = jpegBuf_.size();
+    } else {
+        rh.payloadSize = uint64_t(rh.step) * frame.rows;
+    }
+
+    uint64_t recordOffset = offset_;
+    ofs_.write(reinterpret_cast<const char*>(&rh), sizeof(rh));
+    if (codec_ == Mjpeg) {
+        ofs_.write(reinterpret_cast<const char*>(jpegBuf_.data()), jpegBuf_.size());
+    } else if (frame.isContinuous()) {
+        ofs_.write(reinterpret_cast<const char*>(frame.data), rh.payloadSize);
+    } else {
+        // 非连续内存（如ROI）逐行写入，文件中始终为紧凑存储
+        for (int y = 0; y < frame.rows; ++y)
+            ofs_.write(reinterpret_cast<const char*>(frame.ptr(y)), rh.step);
+    }
+    offset_ += sizeof(rh) + rh.payloadSize;
+    pad();
+
+    if (!ofs_) {
+        qDebug() << "[FrameRecorder] Write failed at frame" << index_.size();
+        return false;
+    }
+    index_.push_back({ recordOffset, timestampUs });
+    return true;
+}
+
+// 写入索引和文件尾，关闭文件
+void FrameRecorder::close()
+{
+    if (!ofs_.is_open())
+        return;
+
+    IndexHeader ih;
+    std::memset(&ih, 0, sizeof(ih));
+    ih.magic = kIndexMagic;
+    ih.count = index_.size();
+    Trailer tr;
+    std::memset(&tr, 0, sizeof(tr));
+    tr.indexOffset = offset_;
+    tr.magic = kTrailerMagic;
+
+    ofs_.write(reinterpret_cast<const char*>(&ih), sizeof(ih));
+    if (!index_.empty())
+        ofs_.write(reinterpret_cast<const char*>(index_.data()), index_.size() * sizeof(IndexEntry));
+    ofs_.write(reinterpret_cast<const char*>(&tr), sizeof(tr));
+    ofs_.close();
+
+    qDebug() << "[FrameRecorder] Closed. Frames recorded:" << index_.size();
+    index_.clear();
+}
+
+void FrameRecorder::pad()
+{
+    static const char zeros[kAlign] = {};
+    uint64_t aligned = alignUp(offset_);
+    if (aligned > offset_)
+        ofs_.write(zeros, aligned - offset_);
+    offset_ = aligned;
+}
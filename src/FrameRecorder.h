@@ -0,0 +1,43 @@
+#ifndef FRAMERECORDER_H
+#define FRAMERECORDER_H
+
+#include "CaptureFormat.h"
+#include <fstream>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+// FrameRecorder 类：将摄像头帧及采集时间戳追加写入 .gcap 录制文件
+class FrameRecorder {
+public:
+    FrameRecorder();
+    // 析构函数，自动写入索引并关闭文件
+    ~FrameRecorder();
+
+    // 创建录制文件，codec 为帧编码方式，jpegQuality 仅对 MJPEG 有效；
+    // path 已存在时不覆盖，改用带编号的新文件（name-1.gcap、name-2.gcap……）
+    bool open(const std::string& path, CaptureFormat::Codec codec, int jpegQuality = 90);
+    // 追加一帧，timestampUs 为采集时间戳（微秒）
+    bool write(const cv::Mat& frame, int64_t timestampUs);
+    // 写入索引和文件尾并关闭文件
+    void close();
+
+    bool isOpen() const { return ofs_.is_open(); }
+    // 实际写入的文件路径
+    const std::string& path() const { return path_; }
+    size_t frameCount() const { return index_.size(); }
+
+private:
+    // 写入填充字节，使当前偏移对齐到 CaptureFormat::kAlign
+    void pad();
+
+    std::ofstream ofs_; // 输出文件流
+    std::string path_; // 实际写入的文件路径
+    CaptureFormat::Codec codec_; // 帧编码方式
+    int jpegQuality_; // JPEG 压缩质量
+    uint64_t offset_; // 当前写入偏移
+    std::vector<CaptureFormat::IndexEntry> index_; // 帧索引（关闭时写入文件）
+    std::vector<uchar> jpegBuf_; // JPEG 编码缓冲区（复用，避免每帧分配）
+};
+
+#endif // FRAMERECORDER_H
@@ -0,0 +1,183 @@
+#include "FrameReplay.h"
+#include <QDebug>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace CaptureFormat;
+
+FrameReplay::FrameReplay()
+    : data_(nullptr)
+    , size_(0)
+    , fd_(-1)
+    , next_(0)
+    , realtime_(true)
+    , startTsUs_(0)
+{
+}
+
+FrameReplay::~FrameReplay()
+{
+    close();
+}
+
+// 打开录制文件并整体映射到内存
+bool FrameReplay::open(const std::string& path)
+{
+    close();
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        qDebug() << "[FrameReplay] Cannot open:" << QString::fromStdString(path);
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd_, &st) != 0 || size_t(st.st_size) < sizeof(FileHeader)) {
+        qDebug() << "[FrameReplay] File too small:" << QString::fromStdString(path);
+        close();
+        return false;
+    }
+    size_ = size_t(st.st_size);
+    // MAP_PRIVATE + 可写：帧数据零拷贝交给下游，若下游误写仅触发写时复制，不会改动文件
+    void* p = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd_, 0);
+    if (p == MAP_FAILED) {
+        qDebug() << "[FrameReplay] mmap failed:" << QString::fromStdString(path);
+        data_ = nullptr;
+        close();
+        return false;
+    }
+    data_ = static_cast<uchar*>(p);
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+
+    const FileHeader* fh = reinterpret_cast<const FileHeader*>(data_);
+    if (fh->magic != kFileMagic || fh->version != kVersion) {
+        qDebug() << "[FrameReplay] Not a capture file:" << QString::fromStdString(path);
+        close();
+        return false;
+    }
+
+    if (!loadIndex()) {
+        qDebug() << "[FrameReplay] No index found, scanning records.";
+        scanIndex();
+    }
+    rewind();
+    qDebug() << "[FrameReplay] Opened:" << QString::fromStdString(path) << "frames:" << index_.size();
+    return true;
+}
+
+void FrameReplay::close()
+{
+    if (data_)
+        ::munmap(data_, size_);
+    if (fd_ >= 0)
+        ::close(fd_);
+    data_ = nullptr;
+    size_ = 0;
+    fd_ = -1;
+    index_.clear();
+    next_ = 0;
+}
+
+// 读取文件尾指向的索引，并校验每个条目
+bool FrameReplay::loadIndex()
+{
+    if (size_ < sizeof(FileHeader) + sizeof(IndexHeader) + sizeof(Trailer))
+        return false;
+    const Trailer* tr = reinterpret_cast<const Trailer*>(data_ + size_ - sizeof(Trailer));
+    // 不用加法比较，避免损坏的 indexOffset 接近 UINT64_MAX 时回绕
+    if (tr->magic != kTrailerMagic || tr->indexOffset % kAlign != 0
+        || tr->indexOffset > size_ - sizeof(Trailer) - sizeof(IndexHeader))
+        return false;
+    const IndexHeader* ih = reinterpret_cast<const IndexHeader*>(data_ + tr->indexOffset);
+    if (ih->count > size_ / sizeof(IndexEntry))
+        return false;
+    uint64_t indexEnd = tr->indexOffset + sizeof(IndexHeader) + ih->count * sizeof(IndexEntry);
+    if (ih->magic != kIndexMagic || indexEnd > size_ - sizeof(Trailer))
+        return false;
+
+    const IndexEntry* entries = reinterpret_cast<const IndexEntry*>(ih + 1);
+    index_.assign(entries, entries + ih->count);
+    for (const IndexEntry& e : index_) {
+        if (!validRecord(e.offset, tr->indexOffset)) {
+            index_.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+// 从第一条记录开始顺序扫描，遇到截断或损坏的记录即停止
+void FrameReplay::scanIndex()
+{
+    index_.clear();
+    uint64_t off = alignUp(sizeof(FileHeader));
+    while (validRecord(off, size_)) {
+        const RecordHeader* rh = reinterpret_cast<const RecordHeader*>(data_ + off);
+        index_.push_back({ off, rh->timestampUs });
+        off = alignUp(off + sizeof(RecordHeader) + rh->payloadSize);
+    }
+}
+
+// 文件内容不可信（崩溃截断、磁盘损坏），Raw 帧交给 cv::Mat 之前必须保证不越界且类型合法
+bool FrameReplay::validRecord(uint64_t offset, uint64_t end) const
+{
+    if (offset % kAlign != 0 || end > size_ || offset > end || end - offset < sizeof(RecordHeader))
+        return false;
+    const RecordHeader* rh = reinterpret_cast<const RecordHeader*>(data_ + offset);
+    if (rh->magic != kRecordMagic || rh->payloadSize > end - offset - sizeof(RecordHeader))
+        return false;
+    if (rh->codec == Mjpeg)
+        return rh->payloadSize > 0 && rh->payloadSize <= uint64_t(INT_MAX);
+    if (rh->codec != Raw || rh->width <= 0 || rh->height <= 0 || rh->type != CV_MAT_TYPE(rh->type)
+        || CV_MAT_DEPTH(rh->type) > CV_64F)
+        return false;
+    const uint64_t rowBytes = uint64_t(rh->width) * CV_ELEM_SIZE(rh->type);
+    return rh->step >= rowBytes && uint64_t(rh->step) * uint64_t(rh->height) <= rh->payloadSize;
+}
+
+// 取第 i 帧
+bool FrameReplay::frame(size_t i, cv::Mat& out) const
+{
+    if (i >= index_.size())
+        return false;
+    const RecordHeader* rh = reinterpret_cast<const RecordHeader*>(data_ + index_[i].offset);
+    uchar* payload = data_ + index_[i].offset + sizeof(RecordHeader);
+
+    if (rh->codec == Mjpeg) {
+        // 用 Mat 头包装映射内存，压缩数据本身不拷贝
+        cv::Mat encoded(1, int(rh->payloadSize), CV_8UC1, payload);
+        out = cv::imdecode(encoded, cv::IMREAD_COLOR);
+        return !out.empty();
+    }
+    if (rh->codec == Raw) {
+        // 尺寸、类型和行宽已在建立索引时由 validRecord 校验
+        out = cv::Mat(rh->height, rh->width, rh->type, payload, rh->step);
+        return true;
+    }
+    qDebug() << "[FrameReplay] Unknown codec:" << rh->codec;
+    return false;
+}
+
+// 顺序读取下一帧，实时模式下按时间戳等待
+bool FrameReplay::read(cv::Mat& out, int64_t& timestampUs)
+{
+    if (next_ >= index_.size())
+        return false;
+
+    timestampUs = index_[next_].timestampUs;
+    if (next_ == 0) {
+        startWall_ = std::chrono::steady_clock::now();
+        startTsUs_ = timestampUs;
+    } else if (realtime_) {
+        std::this_thread::sleep_until(startWall_ + std::chrono::microseconds(timestampUs - startTsUs_));
+    }
+    return frame(next_++, out);
+}
+
+void FrameReplay::rewind()
+{
+    next_ = 0;
+}
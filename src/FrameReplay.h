@@ -0,0 +1,58 @@
+#ifndef FRAMEREPLAY_H
+#define FRAMEREPLAY_H
+
+#include "CaptureFormat.h"
+#include <chrono>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+// FrameReplay 类：以内存映射方式读取 .gcap 录制文件，按原始节奏或全速回放帧
+class FrameReplay {
+public:
+    FrameReplay();
+    // 析构函数，解除映射
+    ~FrameReplay();
+    FrameReplay(const FrameReplay&) = delete;
+    FrameReplay& operator=(const FrameReplay&) = delete;
+
+    // 打开并映射录制文件；缺少索引时顺序扫描重建
+    bool open(const std::string& path);
+    // 解除映射并关闭文件
+    void close();
+
+    bool isOpen() const { return data_ != nullptr; }
+    size_t frameCount() const { return index_.size(); }
+    // 第 i 帧的采集时间戳（微秒）
+    int64_t timestampUs(size_t i) const { return index_[i].timestampUs; }
+
+    // 取第 i 帧：Raw 帧直接引用映射内存（零拷贝，仅在 FrameReplay 打开期间有效），
+    // MJPEG 帧直接从映射内存解码
+    bool frame(size_t i, cv::Mat& out) const;
+    // 顺序读取下一帧；实时模式下按录制时的时间间隔等待，读完返回 false
+    bool read(cv::Mat& out, int64_t& timestampUs);
+    // 回到第一帧
+    void rewind();
+
+    // 设置是否按原始时间间隔回放（false 为全速回放）
+    void setRealtime(bool realtime) { realtime_ = realtime; }
+
+private:
+    // 校验 offset 处的记录：记录头、payload 不超出 end，Raw 帧尺寸/类型/行宽与 payload 一致
+    bool validRecord(uint64_t offset, uint64_t end) const;
+    // 读取文件尾部索引，成功返回 true
+    bool loadIndex();
+    // 顺序扫描记录头重建索引（录制未正常关闭时使用）
+    void scanIndex();
+
+    uchar* data_; // 映射基址
+    size_t size_; // 映射长度
+    int fd_; // 文件描述符
+    std::vector<CaptureFormat::IndexEntry> index_; // 帧索引
+    size_t next_; // 下一帧序号
+    bool realtime_; // 是否实时回放
+    std::chrono::steady_clock::time_point startWall_; // 本轮回放开始的墙上时间
+    int64_t startTsUs_; // 本轮回放第一帧的时间戳
+};
+
+#endif // FRAMEREPLAY_H
@@ -0,0 +1,59 @@
+#include "IouTracker.h"
+
+namespace {
+float iou(const cv::Rect& a, const cv::Rect& b)
+{
+    float inter = float((a & b).area());
+    float uni = float(a.area() + b.area()) - inter;
+    return uni > 0 ? inter / uni : 0.0f;
+}
+}
+
+IouTracker::IouTracker(float iouThreshold, int maxMissed)
+    : iouThreshold_(iouThreshold)
+    , maxMissed_(maxMissed)
+    , nextId_(1)
+{
+}
+
+// 贪心匹配：每个检测框取 IoU 最大且未被占用的同类别目标，匹配不到则新建目标
+std::vector<uint32_t> IouTracker::update(const std::vector<Detection>& dets)
+{
+    std::vector<uint32_t> ids(dets.size(), 0);
+    std::vector<bool> matched(tracks_.size(), false);
+
+    for (size_t d = 0; d < dets.size(); ++d) {
+        int best = -1;
+        float bestIou = iouThreshold_;
+        for (size_t t = 0; t < tracks_.size(); ++t) {
+            if (matched[t] || tracks_[t].classId != dets[d].classId)
+                continue;
+            float v = iou(tracks_[t].box, dets[d].box);
+            if (v >= bestIou) {
+                bestIou = v;
+                best = int(t);
+            }
+        }
+        if (best >= 0) {
+            matched[best] = true;
+            tracks_[best].box = dets[d].box;
+            tracks_[best].missed = 0;
+            ids[d] = tracks_[best].id;
+        } else {
+            ids[d] = nextId_;
+            tracks_.push_back({ nextId_++, dets[d].box, dets[d].classId, 0 });
+            matched.push_back(true);
+        }
+    }
+
+    // 未匹配的目标累计丢失帧数，超过上限则删除
+    size_t keep = 0;
+    for (size_t t = 0; t < tracks_.size(); ++t) {
+        if (!matched[t])
+            ++tracks_[t].missed;
+        if (tracks_[t].missed <= maxMissed_)
+            tracks_[keep++] = tracks_[t];
+    }
+    tracks_.resize(keep);
+    return ids;
+}
@@ -0,0 +1,31 @@
+#ifndef IOUTRACKER_H
+#define IOUTRACKER_H
+
+#include "YoloEngine.h"
+#include <cstdint>
+#include <vector>
+
+// IouTracker 类：按 IoU 贪心匹配相邻帧的同类别检测框，为每个目标分配稳定的跟踪编号
+class IouTracker {
+public:
+    // iouThreshold 为匹配所需的最小 IoU，maxMissed 为目标连续丢失多少帧后删除
+    explicit IouTracker(float iouThreshold = 0.3f, int maxMissed = 5);
+
+    // 输入当前帧检测结果，返回与 dets 一一对应的跟踪编号
+    std::vector<uint32_t> update(const std::vector<Detection>& dets);
+
+private:
+    struct Track {
+        uint32_t id; // 跟踪编号
+        cv::Rect box; // 最近一次的检测框
+        int classId; // 类别
+        int missed; // 连续丢失帧数
+    };
+
+    std::vector<Track> tracks_; // 当前活动目标
+    float iouThreshold_;
+    int maxMissed_;
+    uint32_t nextId_; // 下一个跟踪编号
+};
+
+#endif // IOUTRACKER_H
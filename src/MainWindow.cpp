@@ -8,9 +8,11 @@
 #include <QVBoxLayout>
 
 // MainWindow 构造函数，初始化主界面和各控件
-MainWindow::MainWindow(QWidget* parent)
+MainWindow::MainWindow(const AppOptions& opts, QWidget* parent)
     : QMainWindow(parent)
-    , threshold_(0.5f) // 初始置信度阈值为0.5
+    , detector_(nullptr)
+    , busClient_(nullptr)
+    , threshold_(opts.threshold) // 初始置信度阈值，默认0.5
     , showCameraFps_(true) // 默认显示摄像头FPS
     , cameraFrameCount_(0) // FPS统计帧数
     , lastCameraFpsUpdateMs_(QDateTime::currentMSecsSinceEpoch()) // 上次FPS更新时间
@@ -69,10 +71,22 @@ MainWindow::MainWindow(QWidget* parent)
     setCentralWidget(central);  // 设置中心部件
 
     // --- Detector 设置 & 连接 ---
-    detector_ = new Detector("../resources/yolov5s.onnx", threshold_); // 初始化检测器
-    connect(detector_, &Detector::detection,
-        this, &MainWindow::onDetection,
-        Qt::QueuedConnection); // 检测结果信号连接到槽
+    if (!opts.attach.empty()) {
+        // 连接检测守护进程的帧总线，本进程不加载模型
+        busClient_ = new FrameBusClient(opts.attach, threshold_);
+        connect(busClient_, &FrameBusClient::detection,
+            this, &MainWindow::onDetection,
+            Qt::QueuedConnection); // 检测结果信号连接到槽
+    } else {
+        detector_ = new Detector(opts.modelPath, threshold_); // 初始化检测器
+        detector_->setCaptureOptions(opts.capture); // 录制/回放配置
+        detector_->setEventOptions(opts.events); // 检测事件发布配置
+        detector_->setFrameBusOptions(opts.bus); // 帧总线配置
+        detector_->setCascadeOptions(opts.cascade); // 两级级联配置
+        connect(detector_, &Detector::detection,
+            this, &MainWindow::onDetection,
+            Qt::QueuedConnection); // 检测结果信号连接到槽
+    }
     connect(thresholdSlider_, &QSlider::valueChanged,
         this, &MainWindow::onThresholdChanged); // 滑块变化信号连接
 
@@ -97,8 +111,16 @@ MainWindow::MainWindow(QWidget* parent)
 // 析构函数，安全停止检测线程
 MainWindow::~MainWindow()
 {
-    detector_->stop();
-    detector_->wait();
+    if (detector_) {
+        detector_->stop();
+        detector_->wait();
+        delete detector_;
+    }
+    if (busClient_) {
+        busClient_->stop();
+        busClient_->wait();
+        delete busClient_;
+    }
 }
 
 // 开始检测按钮槽函数
@@ -106,14 +128,20 @@ void MainWindow::onStartClicked()
 {
     qDebug() << "[MainWindow] Start Detect clicked";
     videoPlayer_->playLoop(); // 播放循环视频
-    detector_->start();       // 启动检测线程
+    if (detector_)
+        detector_->start();   // 启动检测线程
+    else
+        busClient_->start();  // 启动帧总线读取线程
 }
 
 // 停止检测按钮槽函数
 void MainWindow::onStopClicked()
 {
     qDebug() << "[MainWindow] Stop Detect clicked";
-    detector_->stop(); // 停止检测
+    if (detector_)
+        detector_->stop(); // 停止检测
+    else
+        busClient_->stop(); // 停止读取帧总线
     stacked_->setCurrentIndex(0); // 切回视频页
     videoPlayer_->playLoop();     // 播放循环视频
 }
@@ -124,7 +152,10 @@ void MainWindow::onThresholdChanged(int value)
     threshold_ = value / 100.0f; // 转换为0~1
     qDebug() << "[MainWindow] Confidence threshold changed to:" << threshold_;
     thresholdValueLabel_->setText(QString("%1%").arg(value)); // 更新显示
-    detector_->setThreshold(threshold_); // 设置检测器阈值
+    if (detector_)
+        detector_->setThreshold(threshold_); // 设置检测器阈值
+    else
+        busClient_->setThreshold(threshold_); // 设置本地显示阈值
 }
 
 // 切换摄像头FPS显示
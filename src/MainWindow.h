@@ -1,7 +1,9 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include "AppOptions.h"
 #include "Detector.h"
+#include "FrameBusClient.h"
 #include "VideoPlayer.h"
 #include <QLabel>
 #include <QMainWindow>
@@ -15,8 +17,8 @@ class MainWindow : public QMainWindow {
     Q_OBJECT
 
 public:
-    // 构造函数，parent为父窗口指针
-    MainWindow(QWidget* parent = nullptr);
+    // 构造函数，opts为命令行配置，parent为父窗口指针
+    MainWindow(const AppOptions& opts = AppOptions(), QWidget* parent = nullptr);
     // 析构函数
     ~MainWindow();
 
@@ -39,7 +41,8 @@ private slots:
 
 private:
     VideoPlayer* videoPlayer_;      // 视频播放器控件
-    Detector* detector_;            // 检测器对象
+    Detector* detector_;            // 检测器对象（连接守护进程时为空）
+    FrameBusClient* busClient_;     // 帧总线客户端（本进程检测时为空）
     QSlider* thresholdSlider_;      // 置信度阈值滑块
     QLabel* thresholdValueLabel_;   // 显示当前阈值的标签
     QPushButton* startBtn_;         // 开始检测按钮
@@ -0,0 +1,205 @@
+#include "YoloEngine.h"
+#include <QDebug>
+#include <QString>
+#include <chrono>
+#include <fstream>
+
+namespace {
+const float INPUT_SIZE = 640.0f; // yolov5s.onnx 输入尺寸
+const int kMaxWH = 7680; // 按类别 NMS 的平移量（同 YOLOv5 max_wh），大于任何输入图像边长
+
+// 计算从 start 到现在经过的毫秒数
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+// 构造函数：加载模型和类别名文件
+YoloEngine::YoloEngine(const std::string& modelPath, bool useCuda)
+    : nmsThreshold_(0.45f)
+    , loaded_(false)
+{
+    // 输出尝试加载模型的信息
+    qDebug() << "[YoloEngine] Trying to load model from:" << QString::fromStdString(modelPath);
+    try {
+        // 加载ONNX模型
+        net_ = cv::dnn::readNet(modelPath);
+        if (useCuda) {
+            // 设置推理后端为CUDA
+            net_.setPreferableBackend(cv::dnn::DNN_BACKEND_CUDA);
+            // 设置推理目标为CUDA FP16
+            net_.setPreferableTarget(cv::dnn::DNN_TARGET_CUDA_FP16);
+        } else {
+            net_.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+            net_.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+        }
+        outNames_ = net_.getUnconnectedOutLayersNames();
+        loaded_ = !net_.empty();
+        qDebug() << "[YoloEngine] Model loaded.";
+    } catch (cv::Exception& e) {
+        // 捕获加载模型异常
+        qDebug() << "[YoloEngine] Model load failed:" << e.what();
+    }
+
+    // 获取模型所在目录
+    std::string baseDir = modelPath.substr(0, modelPath.find_last_of("/\\"));
+    // 构造coco.names路径
+    std::string namesFile = baseDir.empty() ? "coco.names" : (baseDir + "/coco.names");
+    qDebug() << "[YoloEngine] Loading coco.names from:" << QString::fromStdString(namesFile);
+    std::ifstream ifs(namesFile);
+    if (!ifs.is_open()) {
+        // 打开失败
+        qDebug() << "[YoloEngine] Failed to open coco.names";
+    } else {
+        // 逐行读取类别名
+        std::string line;
+        while (std::getline(ifs, line)) {
+            if (!line.empty())
+                classNames_.push_back(line);
+        }
+        qDebug() << "[YoloEngine] Loaded class count:" << classNames_.size();
+    }
+}
+
+// 单帧检测：预处理 -> 前向推理 -> 解码 -> NMS
+bool YoloEngine::detect(const cv::Mat& frame, float threshold,
+    std::vector<Detection>& out, StageTimes* times)
+{
+    out.clear();
+    StageTimes t;
+    auto start = std::chrono::steady_clock::now();
+
+    // 计算输入输出缩放比例
+    float xScale = float(frame.cols) / INPUT_SIZE;
+    float yScale = float(frame.rows) / INPUT_SIZE;
+
+    // 图像预处理：归一化、缩放、通道变换
+    try {
+        /**
+         * 参数解释：
+         * frame: 原始图像，类型为 cv::Mat。
+         * blob: 输出参数，生成的4维张量（NCHW：batch, channels, height, width）。
+         * 1 / 255.0: 缩放因子，把像素值从 [0, 255] 缩放到 [0, 1]（神经网络更易处理）。
+         * cv::Size(INPUT_SIZE, INPUT_SIZE): 目标尺寸，例如 YOLOv5 通常用 640x640，表示将图像缩放到指定大小。
+         * cv::Scalar(): 均值减除值（均值归一化用的），为空则不做减均值操作。
+         * true: swapRB，表示是否交换 R 和 B 通道。因为 OpenCV 默认是 BGR，很多模型需要 RGB，因此这里设为 true。
+         * false: crop，是否在缩放图像时裁剪，设为 false 表示不裁剪，只缩放。
+         *
+         */
+        cv::dnn::blobFromImage(frame, blob_, 1 / 255.0, cv::Size(INPUT_SIZE, INPUT_SIZE), cv::Scalar(), true, false);
+        //将预处理后的图像张量 blob 作为输入喂给神经网络 net_。
+        net_.setInput(blob_);
+    } catch (cv::Exception& e) {
+        qDebug() << "[YoloEngine] blobFromImage/setInput error:" << e.what();
+        return false;
+    }
+    t.preprocessMs = elapsedMs(start);
+
+    // 前向推理，获取模型输出
+    /**
+     * net_.forward(outputs, net_.getUnconnectedOutLayersNames());
+     *
+     * 作用：
+     *   - 执行神经网络的前向传播（推理），将输入数据传递给网络，得到输出结果。
+     *   - outputs: 用于存放网络的输出张量。
+     *   - net_.getUnconnectedOutLayersNames(): 获取所有未连接输出层的名称（即模型的最终输出层），
+     *     这样可以确保输出的是模型的最终推理结果（如YOLO的检测结果）。
+     *     输出层名称在构造时缓存到 outNames_，避免每帧重新查询。
+     * 相关函数：
+     *   - cv::dnn::Net::forward(std::vector<cv::Mat>& outputBlobs, const std::vector<std::string>& outBlobNames):
+     *       - outputBlobs: 用于接收输出层的结果（可以有多个输出）。
+     *       - outBlobNames: 指定要获取的输出层名称列表。
+     *   - cv::dnn::Net::getUnconnectedOutLayersNames():
+     *       - 返回所有未连接输出层（即最终输出层）的名称列表，常用于检测模型（如YOLO、SSD等）。
+     *
+     *   该行代码将模型的推理输出存储到outputs中，供后续解析检测结果使用。
+     */
+    start = std::chrono::steady_clock::now();
+    try {
+        net_.forward(outputs_, outNames_);
+    } catch (cv::Exception& e) {
+        qDebug() << "[YoloEngine] forward() error:" << e.what();
+        return false;
+    }
+    t.forwardMs = elapsedMs(start);
+
+    // 检查输出
+    if (outputs_.empty()) {
+        qDebug() << "[YoloEngine] No outputs.";
+        return false;
+    }
+
+    // 解析输出张量
+    start = std::chrono::steady_clock::now();
+    cv::Mat& o = outputs_[0];
+    int numProposals = o.size[1]; // 检测框数量
+    int dims = o.size[2]; // 每个检测框的属性数
+    const float* data = (const float*)o.data; // 指向输出数据
+
+    candBoxes_.clear();
+    candConfs_.clear();
+    candClassIds_.clear();
+
+    // 遍历所有检测框
+    for (int i = 0; i < numProposals; ++i) {
+        float conf = data[4]; // 置信度
+        if (conf >= threshold) {
+            // 将检测框坐标从输入尺寸映射回原图尺寸
+            float cx = data[0] * xScale;
+            float cy = data[1] * yScale;
+            float w = data[2] * xScale;
+            float h = data[3] * yScale;
+            int left = int(cx - w / 2);
+            int top = int(cy - h / 2);
+            int width = int(w);
+            int height = int(h);
+
+            // 边界修正，防止越界
+            left = std::max(0, left);
+            top = std::max(0, top);
+            width = std::min(width, frame.cols - left);
+            height = std::min(height, frame.rows - top);
+
+            // 解析类别分数，找到最大类别
+            float maxCls = 0;
+            int clsId = -1;
+            for (int c = 5; c < dims; ++c) {
+                if (data[c] > maxCls) {
+                    maxCls = data[c];
+                    clsId = c - 5;
+                }
+            }
+
+            candBoxes_.emplace_back(left, top, width, height);
+            candConfs_.push_back(conf);
+            candClassIds_.push_back(clsId);
+        }
+        // 指针移动到下一个检测框
+        data += dims;
+    }
+    t.decodeMs = elapsedMs(start);
+
+    // 按类别做非极大值抑制，去除同一目标的重复框：与 YOLOv5 相同，框按类别平移 classId*kMaxWH，
+    // 不同类别的框互不重叠，重叠的瓶子和杯子不会互相抑制
+    start = std::chrono::steady_clock::now();
+    nmsBoxes_.resize(candBoxes_.size());
+    for (size_t i = 0; i < candBoxes_.size(); ++i)
+        nmsBoxes_[i] = candBoxes_[i] + cv::Point(candClassIds_[i] * kMaxWH, candClassIds_[i] * kMaxWH);
+    keep_.clear();
+    cv::dnn::NMSBoxes(nmsBoxes_, candConfs_, threshold, nmsThreshold_, keep_);
+    out.reserve(keep_.size());
+    for (int k : keep_) {
+        int clsId = candClassIds_[k];
+        // 获取类别名
+        std::string cocoName = (clsId >= 0 && clsId < (int)classNames_.size())
+            ? classNames_[clsId]
+            : std::to_string(clsId);
+        out.push_back({ candBoxes_[k], candConfs_[k], clsId, cocoName });
+    }
+    t.nmsMs = elapsedMs(start);
+
+    if (times)
+        *times = t;
+    return true;
+}
@@ -0,0 +1,59 @@
+#ifndef YOLOENGINE_H
+#define YOLOENGINE_H
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+// 单个检测结果
+struct Detection {
+    cv::Rect box; // 原图坐标下的检测框
+    float conf; // 置信度
+    int classId; // COCO 类别序号
+    std::string label; // COCO 类别名
+};
+
+// 各阶段耗时（毫秒）
+struct StageTimes {
+    double preprocessMs = 0; // blobFromImage + setInput
+    double forwardMs = 0; // 前向推理
+    double decodeMs = 0; // 输出张量解析
+    double nmsMs = 0; // 非极大值抑制
+    double totalMs() const { return preprocessMs + forwardMs + decodeMs + nmsMs; }
+};
+
+// YoloEngine 类：YOLOv5 ONNX 模型的单帧检测流程（预处理、前向、解码、NMS），不依赖 Qt 界面
+class YoloEngine {
+public:
+    // 构造函数，加载模型及同目录下的 coco.names；useCuda 为 false 时使用 CPU 推理
+    explicit YoloEngine(const std::string& modelPath, bool useCuda = true);
+
+    // 模型是否加载成功
+    bool isLoaded() const { return loaded_; }
+    // coco.names 类别名列表
+    const std::vector<std::string>& classNames() const { return classNames_; }
+    // 设置 NMS 的 IoU 阈值
+    void setNmsThreshold(float t) { nmsThreshold_ = t; }
+
+    // 对一帧执行检测，置信度低于 threshold 的候选框被丢弃；times 非空时填入各阶段耗时
+    bool detect(const cv::Mat& frame, float threshold,
+        std::vector<Detection>& out, StageTimes* times = nullptr);
+
+private:
+    cv::dnn::Net net_; // OpenCV DNN网络对象
+    std::vector<std::string> classNames_; // coco.names类别名列表
+    std::vector<std::string> outNames_; // 输出层名称（加载时缓存）
+    float nmsThreshold_; // NMS IoU 阈值
+    bool loaded_; // 模型是否加载成功
+
+    // 每帧复用的缓冲区，避免重复分配
+    cv::Mat blob_;
+    std::vector<cv::Mat> outputs_;
+    std::vector<cv::Rect> candBoxes_;
+    std::vector<float> candConfs_;
+    std::vector<int> candClassIds_;
+    std::vector<cv::Rect> nmsBoxes_; // 按类别平移后的候选框，仅供 NMS 使用
+    std::vector<int> keep_;
+};
+
+#endif // YOLOENGINE_H
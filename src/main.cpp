@@ -1,5 +1,7 @@
+#include "AppOptions.h"
 #include "MainWindow.h"
 #include <QApplication>
+#include <QCommandLineParser>
 #include <QMetaType>
 #include <opencv2/core.hpp>
 #include <vector>
@@ -23,8 +25,14 @@ int main(int argc, char* argv[])
     // 创建 Qt 应用程序对象，管理应用程序的控制流和主要设置
     QApplication app(argc, argv);
 
+    // 命令行参数：模型、录制/回放、事件发布、帧总线
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    addAppOptions(parser);
+    parser.process(app);
+
     // 创建主窗口对象
-    MainWindow w;
+    MainWindow w(readAppOptions(parser));
     // 显示主窗口
     w.show();
 
@@ -0,0 +1,208 @@
+#include "BenchCommon.h"
+#include "TestUtil.h"
+#include <QJsonDocument>
+#include <cmath>
+#include <cstring>
+
+// 基准测试中与模型无关的部分：
+//   BenchTest data <dir>   检查入库数据可加载
+//   BenchTest agreement    检查 IoU、分位数、一致性评分
+//   BenchTest baseline     检查基线解析，以及模型/延迟/一致性比较能判定回归
+
+namespace {
+Detection makeDet(const std::string& label, cv::Rect box, float conf = 0.9f)
+{
+    Detection d;
+    d.box = box;
+    d.conf = conf;
+    d.classId = 0;
+    d.label = label;
+    return d;
+}
+
+bool near(double a, double b)
+{
+    return std::fabs(a - b) < 1e-9;
+}
+
+QJsonObject fakeModel(const char* file, const char* sha256)
+{
+    QJsonObject o;
+    o["file"] = file;
+    o["bytes"] = 1000.0;
+    o["sha256"] = sha256;
+    return o;
+}
+
+void testData(const char* dataDir)
+{
+    std::vector<std::unique_ptr<FrameReplay>> clips;
+    std::vector<BenchFrame> frames = loadFrames(dataDir, clips);
+    std::printf("loaded %zu frames from %s\n", frames.size(), dataDir);
+    CHECK(!frames.empty());
+    CHECK(!clips.empty()); // 数据集至少含一段 .gcap 录制片段
+    bool hasImage = false;
+    for (const BenchFrame& f : frames) {
+        CHECK(!f.image.empty() && f.image.type() == CV_8UC3);
+        hasImage = hasImage || !f.key.contains(".gcap#");
+    }
+    CHECK(hasImage);
+}
+
+void testAgreement()
+{
+    CHECK(near(iou(cv::Rect(0, 0, 10, 10), cv::Rect(0, 0, 10, 10)), 1.0));
+    CHECK(near(iou(cv::Rect(0, 0, 10, 10), cv::Rect(5, 0, 10, 10)), 50.0 / 150.0));
+    CHECK(near(iou(cv::Rect(0, 0, 10, 10), cv::Rect(20, 20, 5, 5)), 0.0));
+    CHECK(near(iou(cv::Rect(), cv::Rect()), 0.0));
+
+    CHECK(near(percentile({}, 0.5), 0.0));
+    CHECK(near(percentile({ 3, 1, 2 }, 0.5), 2.0));
+    CHECK(near(percentile({ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 }, 0.95), 10.0));
+    CHECK(near(percentile({ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 }, 0.0), 1.0));
+
+    const std::vector<Detection> cur = { makeDet("bottle", cv::Rect(10, 10, 50, 100)),
+        makeDet("cup", cv::Rect(200, 50, 40, 40)) };
+    const QJsonArray base = detectionsToJson(cur);
+    CHECK(near(frameAgreement(QJsonArray(), {}), 1.0));
+    CHECK(near(frameAgreement(base, cur), 1.0));
+    CHECK(near(frameAgreement(base, { cur[1], cur[0] }), 1.0)); // 顺序无关
+    CHECK(near(frameAgreement(base, { cur[0] }), 0.5)); // 漏检
+    CHECK(near(frameAgreement(QJsonArray(), { cur[0] }), 0.0)); // 误检
+    CHECK(near(frameAgreement(base, { cur[0], cur[1], makeDet("cup", cv::Rect(0, 200, 20, 20)) }), 2.0 / 3.0));
+    // 类别不同或 IoU<0.5 不算匹配
+    CHECK(near(frameAgreement(base, { makeDet("can", cur[0].box), cur[1] }), 0.5));
+    CHECK(near(frameAgreement(base, { makeDet("bottle", cv::Rect(40, 10, 50, 100)), cur[1] }), 0.5));
+    // 同一个当前检测不能匹配两个基线检测
+    QJsonArray twice = detectionsToJson({ cur[0], cur[0] });
+    CHECK(near(frameAgreement(twice, { cur[0] }), 0.5));
+}
+
+void testBaseline()
+{
+    QJsonObject base;
+    QString error;
+    CHECK(!parseBaseline("{", base, error));
+    CHECK(!parseBaseline("[]", base, error));
+    CHECK(!parseBaseline("{\"detections\": {}}", base, error));
+    CHECK(!parseBaseline("{\"threshold\": 0.5}", base, error));
+    CHECK(!parseBaseline("{\"threshold\": 0.5, \"detections\": {}, \"latencyMs\": 3}", base, error));
+
+    // 生成 -> 序列化 -> 解析 -> 与自身比较必须通过
+    std::vector<BenchFrame> frames(3);
+    frames[0].key = "a.jpg#0";
+    frames[1].key = "clip.gcap#0";
+    frames[2].key = "clip.gcap#1";
+    std::vector<std::vector<Detection>> results = {
+        { makeDet("bottle", cv::Rect(10, 10, 50, 100)) },
+        {},
+        { makeDet("cup", cv::Rect(200, 50, 40, 40)), makeDet("banana", cv::Rect(0, 0, 30, 20)) },
+    };
+    LatencySummary sum;
+    sum.preprocess = 1.0;
+    sum.forward = 20.0;
+    sum.decode = 2.0;
+    sum.nms = 0.2;
+    sum.total = 23.2;
+    sum.p50Total = 23.0;
+    sum.p95Total = 25.0;
+    QJsonObject models;
+    models["model"] = fakeModel("yolov5s.onnx", "aaaa");
+    const QJsonObject made = makeBaseline(0.5f, models, sum, 123456, frames, results);
+    CHECK(parseBaseline(QJsonDocument(made).toJson(), base, error));
+    CompareOptions opts;
+    opts.models = models;
+    CompareResult r = compareBaseline(base, sum, frames, results, opts);
+    CHECK(r.ok() && near(r.agreement, 1.0) && near(r.positiveAgreement, 1.0));
+
+    // 基线缺少延迟、模型标识或任何检测结果时拒绝解析
+    QJsonObject bad = made;
+    bad.remove("latencyMs");
+    CHECK(!parseBaseline(QJsonDocument(bad).toJson(), base, error));
+    bad = made;
+    QJsonObject lat = bad["latencyMs"].toObject();
+    lat.remove("p95Total");
+    bad["latencyMs"] = lat;
+    CHECK(!parseBaseline(QJsonDocument(bad).toJson(), base, error));
+    bad = made;
+    bad.remove("models");
+    CHECK(!parseBaseline(QJsonDocument(bad).toJson(), base, error));
+    const std::vector<std::vector<Detection>> empty(frames.size());
+    CHECK(!parseBaseline(QJsonDocument(makeBaseline(0.5f, models, sum, 0, frames, empty)).toJson(), base, error));
+    CHECK(parseBaseline(QJsonDocument(made).toJson(), base, error));
+
+    // 延迟回归：超过 基线*(1+tolerance)+slack 判为回归，容差以内通过
+    LatencySummary slow = sum;
+    slow.forward = 20.0 * 1.25 + 0.4;
+    CHECK(compareBaseline(base, slow, frames, results, opts).ok());
+    slow.forward = 20.0 * 1.25 + 0.6;
+    r = compareBaseline(base, slow, frames, results, opts);
+    CHECK(!r.ok() && !r.latencyPass && r.agreementPass);
+
+    // 检测回归：一帧漏检即低于 0.95
+    std::vector<std::vector<Detection>> missing = results;
+    missing[2].pop_back();
+    r = compareBaseline(base, sum, frames, missing, opts);
+    CHECK(!r.ok() && r.latencyPass && !r.agreementPass);
+
+    // 数据集出现基线中没有的帧
+    std::vector<BenchFrame> extra = frames;
+    extra.push_back(BenchFrame());
+    extra.back().key = "new.jpg#0";
+    std::vector<std::vector<Detection>> extraResults = results;
+    extraResults.emplace_back();
+    r = compareBaseline(base, sum, extra, extraResults, opts);
+    CHECK(!r.ok() && r.missingFrames == 1);
+
+    // 基线中的帧从数据集中删除（如删掉有目标的帧）
+    std::vector<BenchFrame> fewer(frames.begin(), frames.begin() + 2);
+    std::vector<std::vector<Detection>> fewerResults(results.begin(), results.begin() + 2);
+    r = compareBaseline(base, sum, fewer, fewerResults, opts);
+    CHECK(!r.ok() && r.staleFrames == 1);
+
+    // 空载帧占多数时，什么都不输出的检测器总体一致性可达 0.95，但有目标的帧一致性为 0
+    std::vector<BenchFrame> mostlyEmpty(21);
+    std::vector<std::vector<Detection>> oneObject(mostlyEmpty.size());
+    for (size_t i = 0; i < mostlyEmpty.size(); ++i)
+        mostlyEmpty[i].key = QString("belt_empty.gcap#%1").arg(i);
+    oneObject[0].push_back(makeDet("bottle", cv::Rect(10, 10, 50, 100)));
+    QJsonObject sparse;
+    CHECK(parseBaseline(QJsonDocument(makeBaseline(0.5f, models, sum, 0, mostlyEmpty, oneObject)).toJson(), sparse, error));
+    r = compareBaseline(sparse, sum, mostlyEmpty, std::vector<std::vector<Detection>>(mostlyEmpty.size()), opts);
+    CHECK(r.agreement >= 0.95 && near(r.positiveAgreement, 0.0) && !r.agreementPass && !r.ok());
+
+    // 模型或级联参数与基线不同：检测结果不可比
+    CompareOptions otherModel = opts;
+    otherModel.models["model"] = fakeModel("yolov5s.onnx", "bbbb");
+    r = compareBaseline(base, sum, frames, results, otherModel);
+    CHECK(!r.ok() && r.modelMismatch);
+    otherModel = opts;
+    otherModel.models["gate"] = fakeModel("yolov5n-192.onnx", "cccc");
+    r = compareBaseline(base, sum, frames, results, otherModel);
+    CHECK(!r.ok() && r.modelMismatch);
+
+    // 阈值与基线不同：检测结果不可比，直接判失败而不是报告一致性回归
+    CompareOptions otherThreshold = opts;
+    otherThreshold.threshold = 0.4f;
+    r = compareBaseline(base, sum, frames, results, otherThreshold);
+    CHECK(!r.ok() && r.thresholdMismatch);
+    otherThreshold.threshold = 0.5f;
+    CHECK(compareBaseline(base, sum, frames, results, otherThreshold).ok());
+}
+}
+
+int main(int argc, char* argv[])
+{
+    const char* mode = argc > 1 ? argv[1] : "";
+    if (std::strcmp(mode, "data") == 0 && argc > 2)
+        testData(argv[2]);
+    else if (std::strcmp(mode, "agreement") == 0)
+        testAgreement();
+    else if (std::strcmp(mode, "baseline") == 0)
+        testBaseline();
+    else {
+        std::printf("usage: %s data <dir> | agreement | baseline\n", argv[0]);
+        return 2;
+    }
+    return TestUtil::finish(mode);
+}
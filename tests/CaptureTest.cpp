@@ -0,0 +1,233 @@
+#include "FrameRecorder.h"
+#include "FrameReplay.h"
+#include "TestUtil.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+// 录制/回放往返测试（不需要模型和摄像头）：写入合成帧后回放比对，
+// 截掉索引和文件尾后检查扫描恢复，篡改记录头后检查回放端拒绝越界或非法的帧
+
+using namespace CaptureFormat;
+
+namespace {
+const int kFrames = 5;
+const int kWidth = 64;
+const int kHeight = 48;
+
+// 第 i 帧合成图像（固定种子，内容可复现）
+cv::Mat makeFrame(int i)
+{
+    cv::Mat m(kHeight, kWidth, CV_8UC3);
+    cv::RNG rng(uint64_t(1000 + i));
+    rng.fill(m, cv::RNG::UNIFORM, 0, 256);
+    return m;
+}
+
+int64_t timestampOf(int i)
+{
+    return 1700000000000000LL + int64_t(i) * 33333;
+}
+
+bool sameImage(const cv::Mat& a, const cv::Mat& b)
+{
+    return a.size() == b.size() && a.type() == b.type() && cv::norm(a, b, cv::NORM_INF) == 0;
+}
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream ifs(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string& path, const std::string& bytes)
+{
+    std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+    ofs.write(bytes.data(), std::streamsize(bytes.size()));
+}
+
+// 第 k 条 Raw 记录在文件中的偏移
+uint64_t rawRecordOffset(int k)
+{
+    const uint64_t payload = uint64_t(kWidth) * 3 * kHeight;
+    return alignUp(sizeof(FileHeader)) + uint64_t(k) * alignUp(sizeof(RecordHeader) + payload);
+}
+
+// 录制 kFrames 帧 Raw 合成图像，返回实际文件路径
+std::string recordRaw(const std::string& path)
+{
+    FrameRecorder rec;
+    if (!rec.open(path, Raw))
+        return std::string();
+    for (int i = 0; i < kFrames; ++i) {
+        if (i == 2) {
+            // 非连续 Mat（ROI）也应按紧凑行存储写入
+            cv::Mat big(kHeight + 8, kWidth + 8, CV_8UC3, cv::Scalar::all(0));
+            makeFrame(i).copyTo(big(cv::Rect(4, 4, kWidth, kHeight)));
+            rec.write(big(cv::Rect(4, 4, kWidth, kHeight)), timestampOf(i));
+        } else {
+            rec.write(makeFrame(i), timestampOf(i));
+        }
+    }
+    return rec.path();
+}
+
+// 回放文件，检查前 expected 帧与录制内容一致
+void checkReplay(const std::string& path, int expected)
+{
+    FrameReplay rp;
+    CHECK(rp.open(path));
+    CHECK(int(rp.frameCount()) == expected);
+    rp.setRealtime(false);
+    cv::Mat m;
+    int64_t ts = 0;
+    for (int i = 0; i < expected; ++i) {
+        CHECK(rp.read(m, ts));
+        CHECK(ts == timestampOf(i));
+        CHECK(sameImage(m, makeFrame(i)));
+    }
+    CHECK(!rp.read(m, ts));
+}
+
+void testRawRoundTrip(const std::string& dir)
+{
+    std::printf("raw round trip\n");
+    std::string path = recordRaw(dir + "/raw.gcap");
+    CHECK(path == dir + "/raw.gcap");
+    checkReplay(path, kFrames);
+}
+
+void testMjpegRoundTrip(const std::string& dir)
+{
+    std::printf("mjpeg round trip\n");
+    FrameRecorder rec;
+    CHECK(rec.open(dir + "/mjpeg.gcap", Mjpeg));
+    // 平滑图像，JPEG 有损但误差应很小
+    std::vector<cv::Mat> src;
+    for (int i = 0; i < kFrames; ++i) {
+        cv::Mat m(kHeight, kWidth, CV_8UC3, cv::Scalar(40 * i, 100, 200 - 30 * i));
+        src.push_back(m);
+        CHECK(rec.write(m, timestampOf(i)));
+    }
+    rec.close();
+
+    FrameReplay rp;
+    CHECK(rp.open(dir + "/mjpeg.gcap"));
+    CHECK(int(rp.frameCount()) == kFrames);
+    for (int i = 0; i < int(rp.frameCount()); ++i) {
+        cv::Mat m;
+        CHECK(rp.frame(size_t(i), m));
+        CHECK(m.size() == src[i].size() && m.type() == CV_8UC3);
+        CHECK(cv::norm(m, src[i], cv::NORM_INF) <= 8);
+        CHECK(rp.timestampUs(size_t(i)) == timestampOf(i));
+    }
+}
+
+// 再次打开同名文件不得截断已有录制
+void testNoTruncate(const std::string& dir)
+{
+    std::printf("no truncate on reopen\n");
+    std::string first = recordRaw(dir + "/incident.gcap");
+    std::string second = recordRaw(dir + "/incident.gcap");
+    std::string third = recordRaw(dir + "/incident.gcap");
+    CHECK(first == dir + "/incident.gcap");
+    CHECK(second == dir + "/incident-1.gcap");
+    CHECK(third == dir + "/incident-2.gcap");
+    checkReplay(first, kFrames);
+    checkReplay(second, kFrames);
+}
+
+// 录制进程崩溃：没有索引和文件尾，或最后一条记录只写了一半
+void testScanRecovery(const std::string& dir)
+{
+    std::printf("scan recovery\n");
+    std::string full = readFile(recordRaw(dir + "/crash.gcap"));
+    const uint64_t dataEnd = rawRecordOffset(kFrames);
+    CHECK(full.size() == dataEnd + sizeof(IndexHeader) + kFrames * sizeof(IndexEntry) + sizeof(Trailer));
+
+    writeFile(dir + "/no_trailer.gcap", full.substr(0, dataEnd));
+    checkReplay(dir + "/no_trailer.gcap", kFrames);
+
+    // 截断在最后一帧 payload 中间
+    writeFile(dir + "/half_frame.gcap", full.substr(0, rawRecordOffset(kFrames - 1) + sizeof(RecordHeader) + 100));
+    checkReplay(dir + "/half_frame.gcap", kFrames - 1);
+
+    // 只剩文件头
+    writeFile(dir + "/header_only.gcap", full.substr(0, sizeof(FileHeader)));
+    checkReplay(dir + "/header_only.gcap", 0);
+}
+
+// 篡改第 k 条记录头后，索引和扫描两条路径都不得交出越界或类型非法的帧
+void testCorruptRecords(const std::string& dir)
+{
+    std::printf("corrupt records\n");
+    const std::string full = readFile(recordRaw(dir + "/good.gcap"));
+    const uint64_t dataEnd = rawRecordOffset(kFrames);
+    const int k = 2;
+
+    struct Corruption {
+        const char* name;
+        void (*apply)(RecordHeader&);
+    };
+    const Corruption corruptions[] = {
+        { "step", [](RecordHeader& rh) { rh.step *= 4; } },
+        { "height", [](RecordHeader& rh) { rh.height *= 2; } },
+        { "short_step", [](RecordHeader& rh) { rh.step = uint32_t(rh.width); } },
+        { "type", [](RecordHeader& rh) { rh.type = 0x7fffffff; } },
+        { "depth", [](RecordHeader& rh) { rh.type = CV_MAKETYPE(7, 3); } },
+        { "codec", [](RecordHeader& rh) { rh.codec = 9; } },
+        { "width", [](RecordHeader& rh) { rh.width = -1; } },
+    };
+    for (const Corruption& c : corruptions) {
+        std::printf("  %s\n", c.name);
+        std::string bytes = full;
+        RecordHeader rh;
+        std::memcpy(&rh, &bytes[rawRecordOffset(k)], sizeof(rh));
+        c.apply(rh);
+        std::memcpy(&bytes[rawRecordOffset(k)], &rh, sizeof(rh));
+
+        // 索引完整：索引校验失败后退回扫描，扫描停在损坏记录之前
+        writeFile(dir + "/corrupt.gcap", bytes);
+        checkReplay(dir + "/corrupt.gcap", k);
+        // 无索引：直接扫描
+        writeFile(dir + "/corrupt.gcap", bytes.substr(0, dataEnd));
+        checkReplay(dir + "/corrupt.gcap", k);
+    }
+
+    // 索引条目指向未对齐或越界的偏移
+    std::string bytes = full;
+    IndexEntry e;
+    const uint64_t entryOffset = dataEnd + sizeof(IndexHeader) + k * sizeof(IndexEntry);
+    std::memcpy(&e, &bytes[entryOffset], sizeof(e));
+    e.offset = uint64_t(-64);
+    std::memcpy(&bytes[entryOffset], &e, sizeof(e));
+    writeFile(dir + "/bad_index.gcap", bytes);
+    checkReplay(dir + "/bad_index.gcap", kFrames); // 索引无效，扫描恢复全部帧
+
+    // 文件尾的 indexOffset 损坏：接近 UINT64_MAX（加法回绕）、未对齐、越界，均应退回扫描
+    const uint64_t badOffsets[] = { uint64_t(-1), uint64_t(-8), uint64_t(-64), dataEnd + 1, uint64_t(full.size()) };
+    for (uint64_t off : badOffsets) {
+        std::printf("  trailer indexOffset %llu\n", (unsigned long long)off);
+        bytes = full;
+        Trailer tr;
+        std::memcpy(&tr, &bytes[bytes.size() - sizeof(Trailer)], sizeof(tr));
+        tr.indexOffset = off;
+        std::memcpy(&bytes[bytes.size() - sizeof(Trailer)], &tr, sizeof(tr));
+        writeFile(dir + "/bad_trailer.gcap", bytes);
+        checkReplay(dir + "/bad_trailer.gcap", kFrames);
+    }
+}
+}
+
+int main()
+{
+    const std::string dir = TestUtil::makeTempDir();
+    CHECK(!dir.empty());
+    testRawRoundTrip(dir);
+    testMjpegRoundTrip(dir);
+    testNoTruncate(dir);
+    testScanRecovery(dir);
+    testCorruptRecords(dir);
+    TestUtil::removeDir(dir);
+    return TestUtil::finish("CaptureTest");
+}
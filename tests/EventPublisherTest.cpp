@@ -0,0 +1,242 @@
+#include "EventPublisher.h"
+#include "TestUtil.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <chrono>
+#include <clocale>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <thread>
+
+// 事件发布测试（不需要模型和摄像头）：套接字端检查队列满时两种丢弃策略的计数和送达的序号，
+// JSON 行在逗号小数点的区域设置下、类别名含需转义字符时仍可解析；
+// 共享内存端用序列锁读取，检查被覆盖的槽，以及并发发布时读不到撕裂的记录
+
+using namespace EventFormat;
+
+namespace {
+// 套接字端收到的一条事件
+struct Received {
+    uint64_t seq;
+    std::string label;
+    double conf;
+};
+
+// 第 i 条事件，各字段由 i 推出，读端可据此检查记录是否完整
+EventRecord makeRecord(uint64_t i)
+{
+    EventRecord r;
+    std::memset(&r, 0, sizeof(r));
+    r.category = Recyclable;
+    r.timestampUs = 1700000000000000LL + int64_t(i);
+    r.frameId = i * 3;
+    r.trackId = uint32_t(i);
+    r.classId = 39;
+    r.conf = 0.8765f;
+    r.x = int32_t(i);
+    r.y = int32_t(i * 2);
+    r.w = 50;
+    r.h = 100;
+    return r;
+}
+
+bool consistent(const EventRecord& r, uint64_t seq)
+{
+    return r.magic == kRecordMagic && r.seq == seq && r.frameId == seq * 3 && r.trackId == uint32_t(seq)
+        && r.x == int32_t(seq) && r.y == int32_t(seq * 2) && r.timestampUs == 1700000000000000LL + int64_t(seq);
+}
+
+int connectTo(const std::string& path)
+{
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    // 等写线程接受连接，之后发布的事件才会发给这个客户端
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    return fd;
+}
+
+// 读到发布器关闭连接为止，逐行解析 JSON
+std::vector<Received> readJsonLines(int fd)
+{
+    std::string buf;
+    char chunk[4096];
+    ssize_t n;
+    while ((n = ::read(fd, chunk, sizeof(chunk))) > 0)
+        buf.append(chunk, size_t(n));
+    ::close(fd);
+
+    std::vector<Received> out;
+    size_t pos = 0, eol;
+    while ((eol = buf.find('\n', pos)) != std::string::npos) {
+        const QByteArray line(buf.data() + pos, int(eol - pos));
+        pos = eol + 1;
+        QJsonParseError pe;
+        const QJsonDocument doc = QJsonDocument::fromJson(line, &pe);
+        if (pe.error != QJsonParseError::NoError || !doc.isObject()) {
+            std::printf("  bad JSON line: %s\n", line.constData());
+            CHECK(false);
+            continue;
+        }
+        const QJsonObject o = doc.object();
+        out.push_back({ uint64_t(o["seq"].toDouble()), o["label"].toString().toStdString(), o["conf"].toDouble() });
+    }
+    CHECK(pos == buf.size()); // 没有不完整的行
+    return out;
+}
+
+// 队列容量 8，发布 20 条：丢弃 12 条，最旧或最新的 8 条送达
+void testDropPolicy(const std::string& dir, EventDropPolicy policy)
+{
+    const bool oldest = policy == EventDropPolicy::DropOldest;
+    std::printf("drop policy %s\n", oldest ? "oldest" : "newest");
+    EventOptions o;
+    o.socketPath = dir + "/events.sock";
+    o.dropPolicy = policy;
+    o.queueCapacity = 8;
+    // 批次大于队列容量且刷新间隔很长：停止前写线程不会取走事件，队列内容确定
+    o.batchSize = 64;
+    o.flushIntervalUs = 10 * 1000 * 1000;
+    const uint64_t n = 20;
+
+    int fd;
+    {
+        EventPublisher pub(o);
+        fd = connectTo(o.socketPath);
+        CHECK(fd >= 0);
+        for (uint64_t i = 1; i <= n; ++i)
+            pub.publish(makeRecord(i), "bottle");
+        CHECK(pub.publishedCount() == n);
+        CHECK(pub.queueDropCount() == n - o.queueCapacity);
+    } // 析构时发出队列中剩余的事件并关闭连接
+    if (fd < 0)
+        return;
+
+    std::vector<Received> got = readJsonLines(fd);
+    CHECK(got.size() == o.queueCapacity);
+    const uint64_t first = oldest ? n - o.queueCapacity + 1 : 1;
+    for (size_t k = 0; k < got.size(); ++k)
+        CHECK(got[k].seq == first + k);
+}
+
+// 类别名含引号、反斜杠和控制字符，且 LC_NUMERIC 为逗号小数点时，每行仍是合法 JSON
+void testJson(const std::string& dir)
+{
+    const char* locale = std::setlocale(LC_NUMERIC, "de_DE.UTF-8");
+    std::printf("json lines (LC_NUMERIC %s)\n", locale ? locale : "C, de_DE.UTF-8 not installed");
+    EventOptions o;
+    o.socketPath = dir + "/json.sock";
+    const std::vector<std::string> labels = { "bottle", "wine \"glass\"", "back\\slash", "tab\tnew\nline", "ctl\x01" };
+
+    int fd;
+    {
+        EventPublisher pub(o);
+        fd = connectTo(o.socketPath);
+        CHECK(fd >= 0);
+        for (size_t i = 0; i < labels.size(); ++i)
+            pub.publish(makeRecord(i + 1), labels[i]);
+    }
+    std::setlocale(LC_NUMERIC, "C");
+    if (fd < 0)
+        return;
+
+    std::vector<Received> got = readJsonLines(fd);
+    CHECK(got.size() == labels.size());
+    for (size_t i = 0; i < got.size() && i < labels.size(); ++i) {
+        CHECK(got[i].seq == i + 1);
+        CHECK(got[i].label == labels[i]);
+        CHECK(std::fabs(got[i].conf - 0.8765) < 1e-9);
+    }
+}
+
+// 序列锁读取第 seq 条记录：版本号前后一致且属于 seq 才算读到完整记录
+bool readSlot(const ShmHeader* hdr, uint64_t seq, EventRecord& r)
+{
+    const ShmSlot& slot = reinterpret_cast<const ShmSlot*>(hdr + 1)[seq % hdr->slotCount];
+    uint64_t v1 = slot.version.load(std::memory_order_acquire);
+    r = slot.record;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t v2 = slot.version.load(std::memory_order_relaxed);
+    return v1 == v2 && v1 == 2 * seq + 2;
+}
+
+void testShm()
+{
+    std::printf("shm ring\n");
+    EventOptions o;
+    o.shmName = "/gc_test_events_" + std::to_string(::getpid());
+    o.shmSlots = 8;
+    EventPublisher pub(o);
+    for (uint64_t i = 1; i <= 10; ++i)
+        pub.publish(makeRecord(i), "bottle");
+
+    // 读端只读映射，与 EventConsumer 相同
+    int fd = ::shm_open(o.shmName.c_str(), O_RDONLY, 0);
+    CHECK(fd >= 0);
+    if (fd < 0)
+        return;
+    const size_t size = shmSize(o.shmSlots);
+    void* p = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    CHECK(p != MAP_FAILED);
+    if (p == MAP_FAILED)
+        return;
+    const ShmHeader* hdr = static_cast<const ShmHeader*>(p);
+    CHECK(hdr->magic == kShmMagic && hdr->version == kVersion && hdr->slotCount == o.shmSlots);
+    CHECK(hdr->writeSeq.load(std::memory_order_acquire) == 10);
+
+    // 8 个槽只保留最近 8 条，第 1、2 条已被覆盖
+    EventRecord r;
+    CHECK(!readSlot(hdr, 1, r));
+    CHECK(!readSlot(hdr, 2, r));
+    for (uint64_t seq = 3; seq <= 10; ++seq)
+        CHECK(readSlot(hdr, seq, r) && consistent(r, seq));
+
+    // 并发：读线程反复读取最新记录，版本号通过的记录必须完整
+    std::atomic<bool> done(false);
+    uint64_t reads = 0, torn = 0;
+    std::thread reader([&] {
+        EventRecord rec;
+        while (!done.load(std::memory_order_relaxed)) {
+            const uint64_t seq = hdr->writeSeq.load(std::memory_order_acquire);
+            if (readSlot(hdr, seq, rec)) {
+                ++reads;
+                if (!consistent(rec, seq))
+                    ++torn;
+            }
+        }
+    });
+    for (uint64_t i = 11; i <= 200000; ++i)
+        pub.publish(makeRecord(i), "bottle");
+    done = true;
+    reader.join();
+    std::printf("  concurrent reads %llu, torn %llu\n", (unsigned long long)reads, (unsigned long long)torn);
+    CHECK(reads > 0);
+    CHECK(torn == 0);
+    CHECK(hdr->writeSeq.load(std::memory_order_acquire) == 200000);
+    ::munmap(p, size);
+}
+}
+
+int main()
+{
+    const std::string dir = TestUtil::makeTempDir();
+    CHECK(!dir.empty());
+    testDropPolicy(dir, EventDropPolicy::DropOldest);
+    testDropPolicy(dir, EventDropPolicy::DropNewest);
+    testJson(dir);
+    testShm();
+    TestUtil::removeDir(dir);
+    return TestUtil::finish("EventPublisherTest");
+}
@@ -0,0 +1,197 @@
+#include "FrameBusReader.h"
+#include "FrameBusWriter.h"
+#include "TestUtil.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// 帧总线往返测试（不需要模型和摄像头）：写端发布合成帧，读端按序和只读最新两种方式读取，
+// 检查读得太慢时的丢帧计数、槽被覆盖后的校验，以及篡改槽头后读端拒绝越界的帧
+
+using namespace FrameBusFormat;
+
+namespace {
+const int kWidth = 64;
+const int kHeight = 48;
+const uint32_t kSlots = 4;
+
+// 第 seq 帧的合成图像和检测结果，读端据此检查内容
+cv::Mat makeFrame(uint64_t seq)
+{
+    return cv::Mat(kHeight, kWidth, CV_8UC3, cv::Scalar(double(seq % 256), 100, double(255 - seq % 256)));
+}
+
+std::vector<Detection> makeDets(uint64_t seq)
+{
+    Detection d;
+    d.box = cv::Rect(int(seq), 2, 10, 20);
+    d.conf = 0.75f;
+    d.classId = 39;
+    d.label = "bottle";
+    return { d };
+}
+
+int64_t timestampOf(uint64_t seq)
+{
+    return 1700000000000000LL + int64_t(seq) * 33333;
+}
+
+void publish(FrameBusWriter& w, uint64_t seq)
+{
+    w.publish(makeFrame(seq), timestampOf(seq), seq * 10, makeDets(seq));
+}
+
+// 读到的帧与第 seq 帧一致
+void checkView(const FrameView& v, uint64_t seq)
+{
+    CHECK(v.seq == seq);
+    CHECK(v.timestampUs == timestampOf(seq));
+    CHECK(v.frameId == seq * 10);
+    const cv::Mat expected = makeFrame(seq);
+    CHECK(v.image.size() == expected.size() && v.image.type() == expected.type());
+    CHECK(!v.image.empty() && cv::norm(v.image, expected, cv::NORM_INF) == 0);
+    CHECK(v.dets.size() == 1);
+    if (v.dets.size() == 1) {
+        CHECK(v.dets[0].box == cv::Rect(int(seq), 2, 10, 20));
+        CHECK(v.dets[0].classId == 39 && v.dets[0].label == "bottle");
+    }
+}
+
+// 读写映射同一总线，模拟损坏或恶意的写端
+SlotHeader* mapSlot(const std::string& name, uint64_t seq, void*& base, size_t& size)
+{
+    base = MAP_FAILED;
+    size = 0;
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+        return nullptr;
+    size = size_t(busSize(kSlots, uint64_t(kWidth) * 3 * kHeight));
+    base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED)
+        return nullptr;
+    const BusHeader* h = static_cast<const BusHeader*>(base);
+    return reinterpret_cast<SlotHeader*>(static_cast<uchar*>(base) + sizeof(BusHeader) + (seq % kSlots) * h->slotStride);
+}
+
+void testRoundTrip(const std::string& name)
+{
+    std::printf("round trip\n");
+    FrameBusOptions o;
+    o.name = name;
+    o.slots = kSlots;
+    o.frameCapacity = uint64_t(kWidth) * 3 * kHeight;
+    FrameBusWriter w(o);
+    CHECK(w.isOpen());
+
+    // 读端从打开时的最新帧开始
+    uint64_t seq = 0;
+    publish(w, ++seq);
+    FrameBusReader r;
+    CHECK(r.open(name));
+    CHECK(r.alive(1000));
+    publish(w, ++seq);
+    publish(w, ++seq);
+
+    // 按序读取
+    FrameView v;
+    for (uint64_t expect = 1; expect <= 3; ++expect) {
+        CHECK(r.next(v, false));
+        checkView(v, expect);
+        CHECK(r.validate(v));
+    }
+    CHECK(!r.next(v, false)); // 没有新帧
+    CHECK(r.lostCount() == 0);
+
+    // 只读最新帧
+    publish(w, ++seq);
+    publish(w, ++seq);
+    CHECK(r.next(v, true));
+    checkView(v, 5);
+    CHECK(!r.next(v, true));
+
+    // 零拷贝：槽被覆盖后 validate 失败
+    const FrameView held = v;
+    for (uint32_t i = 0; i < kSlots; ++i)
+        publish(w, ++seq);
+    CHECK(!r.validate(held));
+
+    // 读得太慢：按序读取跳到最旧的安全帧（head-slotCount+2），其余计入丢帧
+    CHECK(r.next(v, true)); // 追到最新（9）
+    for (int i = 0; i < 10; ++i)
+        publish(w, ++seq); // 10..19
+    const uint64_t head = seq;
+    const uint64_t oldest = head - (kSlots - 1) + 1;
+    for (uint64_t expect = oldest; expect <= head; ++expect) {
+        CHECK(r.next(v, false));
+        checkView(v, expect);
+    }
+    CHECK(!r.next(v, false));
+    CHECK(r.lostCount() == oldest - 10);
+
+    // 超过 frameCapacity 的图像只发布检测结果
+    ++seq;
+    w.publish(cv::Mat(kHeight * 2, kWidth, CV_8UC3, cv::Scalar::all(0)), timestampOf(seq), seq * 10, makeDets(seq));
+    CHECK(r.next(v, false));
+    CHECK(v.seq == seq && v.image.empty() && v.dets.size() == 1);
+}
+
+// 篡改槽头（版本号保持有效）后，读端跳过该帧而不是让 Mat 越界，随后的帧照常读取
+void testTamperedSlot(const std::string& name)
+{
+    std::printf("tampered slot header\n");
+    FrameBusOptions o;
+    o.name = name;
+    o.slots = kSlots;
+    o.frameCapacity = uint64_t(kWidth) * 3 * kHeight;
+    FrameBusWriter w(o);
+    uint64_t seq = 0;
+    publish(w, ++seq);
+    FrameBusReader r;
+    CHECK(r.open(name));
+    FrameView v;
+    CHECK(r.next(v, false));
+
+    struct Corruption {
+        const char* name;
+        void (*apply)(SlotHeader&);
+    };
+    const Corruption corruptions[] = {
+        { "step", [](SlotHeader& s) { s.step *= 4; } },
+        { "short_step", [](SlotHeader& s) { s.step = uint32_t(s.width); } },
+        { "height", [](SlotHeader& s) { s.height *= 2; } },
+        { "width", [](SlotHeader& s) { s.width = -1; } },
+        { "type", [](SlotHeader& s) { s.type = 0x7fffffff; } },
+        { "depth", [](SlotHeader& s) { s.type = CV_MAKETYPE(7, 3); } },
+        { "frame_bytes", [](SlotHeader& s) { s.frameBytes = ~uint64_t(0); } },
+    };
+    for (const Corruption& c : corruptions) {
+        std::printf("  %s\n", c.name);
+        publish(w, ++seq);
+        void* base;
+        size_t size;
+        SlotHeader* slot = mapSlot(name, seq, base, size);
+        CHECK(slot != nullptr);
+        if (!slot)
+            return;
+        c.apply(*slot);
+        ::munmap(base, size);
+
+        CHECK(!r.next(v, false));
+        CHECK(v.image.empty());
+        publish(w, ++seq);
+        CHECK(r.next(v, false));
+        checkView(v, seq);
+    }
+    CHECK(r.lostCount() == 0);
+}
+}
+
+int main()
+{
+    const std::string name = "/gc_test_frames_" + std::to_string(::getpid());
+    testRoundTrip(name);
+    testTamperedSlot(name);
+    return TestUtil::finish("FrameBusTest");
+}
@@ -0,0 +1,66 @@
+#ifndef TESTUTIL_H
+#define TESTUTIL_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// 最小测试辅助：不依赖测试框架，失败时打印位置并计数，main 返回非零
+namespace TestUtil {
+
+inline int& failures()
+{
+    static int n = 0;
+    return n;
+}
+
+// 在 /tmp 下创建临时目录
+inline std::string makeTempDir()
+{
+    char tmpl[] = "/tmp/gc_test_XXXXXX";
+    const char* dir = ::mkdtemp(tmpl);
+    return dir ? std::string(dir) : std::string();
+}
+
+// 递归删除临时目录（不跟随符号链接）
+inline void removeDir(const std::string& dir)
+{
+    DIR* d = dir.empty() ? nullptr : ::opendir(dir.c_str());
+    if (!d)
+        return;
+    while (const dirent* e = ::readdir(d)) {
+        const std::string name = e->d_name;
+        if (name == "." || name == "..")
+            continue;
+        const std::string path = dir + "/" + name;
+        struct stat st;
+        if (::lstat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+            removeDir(path);
+        else
+            ::unlink(path.c_str());
+    }
+    ::closedir(d);
+    ::rmdir(dir.c_str());
+}
+
+// 输出结果并返回进程退出码
+inline int finish(const char* name)
+{
+    std::printf("[%s] %s (%d failure(s))\n", name, failures() ? "FAIL" : "PASS", failures());
+    return failures() ? 1 : 0;
+}
+
+} // namespace TestUtil
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            std::printf("  CHECK failed: %s (%s:%d)\n", #cond, __FILE__, __LINE__); \
+            ++TestUtil::failures();                                              \
+        }                                                                        \
+    } while (0)
+
+#endif // TESTUTIL_H
@@ -0,0 +1,156 @@
+#include "EventFormat.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+// 检测事件参考消费端：连接 Unix 域套接字或映射共享内存环形缓冲区，逐条打印事件及端到端延迟
+//
+// 用法：
+//   GarbageEventConsumer --socket /tmp/gc_events.sock [--binary]
+//   GarbageEventConsumer --shm /gc_events
+
+using namespace EventFormat;
+
+namespace {
+int64_t nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void printRecord(const EventRecord& r)
+{
+    std::printf("seq=%llu frame=%llu track=%u class=%d category=\"%s\" conf=%.3f box=[%d,%d,%d,%d] latency=%lldus\n",
+        (unsigned long long)r.seq, (unsigned long long)r.frameId, r.trackId, r.classId,
+        categoryName(r.category), r.conf, r.x, r.y, r.w, r.h, (long long)(nowUs() - r.timestampUs));
+    std::fflush(stdout);
+}
+
+// 读取套接字：JSON-lines 原样输出，二进制按 EventRecord 解析
+int consumeSocket(const std::string& path, bool binary)
+{
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::perror("[EventConsumer] connect");
+        return 1;
+    }
+
+    std::string buf;
+    char chunk[4096];
+    for (;;) {
+        ssize_t n = ::read(fd, chunk, sizeof(chunk));
+        if (n <= 0)
+            break;
+        buf.append(chunk, size_t(n));
+        size_t used = 0;
+        if (binary) {
+            while (buf.size() - used >= sizeof(EventRecord)) {
+                EventRecord r;
+                std::memcpy(&r, buf.data() + used, sizeof(r));
+                used += sizeof(r);
+                if (r.magic != kRecordMagic) {
+                    std::fprintf(stderr, "[EventConsumer] Bad record magic, stream out of sync.\n");
+                    return 1;
+                }
+                printRecord(r);
+            }
+        } else {
+            size_t eol;
+            while ((eol = buf.find('\n', used)) != std::string::npos) {
+                std::fwrite(buf.data() + used, 1, eol - used + 1, stdout);
+                used = eol + 1;
+            }
+            std::fflush(stdout);
+        }
+        buf.erase(0, used);
+    }
+    std::fprintf(stderr, "[EventConsumer] Publisher closed the connection.\n");
+    ::close(fd);
+    return 0;
+}
+
+// 轮询共享内存环形缓冲区，被覆盖的记录计为丢失
+int consumeShm(const std::string& name)
+{
+    int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    struct stat st;
+    if (fd < 0 || ::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(ShmHeader)) {
+        std::perror("[EventConsumer] shm_open");
+        return 1;
+    }
+    void* p = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        std::perror("[EventConsumer] mmap");
+        return 1;
+    }
+    const ShmHeader* hdr = static_cast<const ShmHeader*>(p);
+    if (hdr->magic != kShmMagic || shmSize(hdr->slotCount) > size_t(st.st_size)) {
+        std::fprintf(stderr, "[EventConsumer] Not an event ring: %s\n", name.c_str());
+        return 1;
+    }
+    const ShmSlot* slots = reinterpret_cast<const ShmSlot*>(hdr + 1);
+    const uint64_t slotCount = hdr->slotCount;
+
+    // 从当前最新位置开始读，不回放历史
+    uint64_t next = hdr->writeSeq.load(std::memory_order_acquire) + 1;
+    uint64_t lost = 0;
+    for (;;) {
+        uint64_t head = hdr->writeSeq.load(std::memory_order_acquire);
+        if (head < next) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            continue;
+        }
+        if (head - next >= slotCount) {
+            // 读得太慢，已被覆盖
+            uint64_t skip = head - slotCount + 1 - next;
+            lost += skip;
+            next += skip;
+            std::fprintf(stderr, "[EventConsumer] Overrun, lost %llu events in total.\n", (unsigned long long)lost);
+        }
+        const ShmSlot& slot = slots[next % slotCount];
+        uint64_t v1 = slot.version.load(std::memory_order_acquire);
+        EventRecord r = slot.record;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t v2 = slot.version.load(std::memory_order_relaxed);
+        if (v1 != v2 || v1 != 2 * next + 2) {
+            // 正在写入或已被新数据覆盖，重新判断
+            continue;
+        }
+        printRecord(r);
+        ++next;
+    }
+}
+}
+
+int main(int argc, char* argv[])
+{
+    std::string socketPath, shmName;
+    bool binary = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc)
+            socketPath = argv[++i];
+        else if (arg == "--shm" && i + 1 < argc)
+            shmName = argv[++i];
+        else if (arg == "--binary")
+            binary = true;
+    }
+    if (!socketPath.empty())
+        return consumeSocket(socketPath, binary);
+    if (!shmName.empty())
+        return consumeShm(shmName);
+    std::fprintf(stderr, "usage: %s --socket <path> [--binary] | --shm <name>\n", argv[0]);
+    return 2;
+}
@@ -0,0 +1,47 @@
+#include "FrameBusReader.h"
+#include <QCoreApplication>
+#include <QThread>
+#include <cstdio>
+
+// 帧总线参考客户端：按序读取检测守护进程发布的检测结果并逐帧打印，不拷贝图像
+//
+// 用法：GarbageFrameBusLogger [/gc_frames]
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    const std::string name = argc > 1 ? argv[1] : "/gc_frames";
+
+    FrameBusReader reader;
+    while (!reader.open(name)) {
+        std::fprintf(stderr, "[FrameBusLogger] Waiting for frame bus %s ...\n", name.c_str());
+        QThread::sleep(1);
+    }
+
+    FrameView view;
+    uint64_t lostReported = 0;
+    for (;;) {
+        if (!reader.alive(2000)) {
+            // 守护进程退出、重启或尚未发布第一帧（心跳为 0）：重新映射，仍无心跳时等待，避免空转
+            if (!reader.open(name) || !reader.alive(2000)) {
+                QThread::msleep(500);
+                continue;
+            }
+        }
+        if (!reader.next(view, false)) {
+            QThread::msleep(2);
+            continue;
+        }
+        std::printf("seq=%llu frame=%llu ts_us=%lld size=%dx%d dets=%zu",
+            (unsigned long long)view.seq, (unsigned long long)view.frameId, (long long)view.timestampUs,
+            view.image.cols, view.image.rows, view.dets.size());
+        for (const Detection& d : view.dets)
+            std::printf(" [%s %.2f %d,%d,%d,%d]", d.label.c_str(), d.conf, d.box.x, d.box.y, d.box.width, d.box.height);
+        std::printf("\n");
+        std::fflush(stdout);
+        if (reader.lostCount() != lostReported) {
+            lostReported = reader.lostCount();
+            std::fprintf(stderr, "[FrameBusLogger] Lost %llu frames in total.\n", (unsigned long long)lostReported);
+        }
+    }
+}